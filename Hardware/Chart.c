@@ -0,0 +1,122 @@
+/*==============================================================================
+  文件：Chart.c
+  功能：OLED 传感器历史曲线页
+        屏幕按列做环形扫描：第 N 个采样画在第 N%128 列，右侧一列清空作为扫描光标。
+        每个新采样只改写一列（8 页各 1 字节），不需要整屏重画。
+        屏幕自上而下分三条曲线：光照 %、车速、距离。
+==============================================================================*/
+#include "stm32f10x.h"
+#include "OLED.h"
+#include "Chart.h"
+
+#define CHART_BANDS         3
+#define CHART_BAND_HEIGHT   20      // 每条曲线高度（像素）
+#define CHART_BAND_GAP      2       // 曲线间隔
+#define CHART_INVALID       0xFF    // 无效采样（如超声超时）
+
+// 每个采样保存三条曲线的高度 0~CHART_BAND_HEIGHT-1
+static uint8_t chart_level[CHART_SAMPLES][CHART_BANDS];
+static uint8_t chart_head = 0;      // 下一个采样写入位置（即光标列）
+static uint8_t chart_count = 0;     // 已有采样数
+
+/**
+  * @brief  数值按满量程换算为曲线高度
+  */
+static uint8_t Chart_Scale(uint32_t value, uint32_t full)
+{
+    if (value > full) value = full;
+    return (uint8_t)(value * (CHART_BAND_HEIGHT - 1) / full);
+}
+
+/**
+  * @brief  在列数据中置一段竖线 [y0, y1]
+  */
+static void Chart_SetSpan(uint8_t *column, uint8_t y0, uint8_t y1)
+{
+    if (y0 > y1) {
+        uint8_t t = y0; y0 = y1; y1 = t;
+    }
+    for (uint8_t y = y0; y <= y1; y++) {
+        column[y >> 3] |= (uint8_t)(1 << (y & 7));
+    }
+}
+
+/**
+  * @brief  生成并写入第 index 个采样对应的列，与前一个采样连成竖线
+  */
+static void Chart_DrawSample(uint8_t index)
+{
+    uint8_t column[8] = {0};
+    uint8_t prev = (index + CHART_SAMPLES - 1) % CHART_SAMPLES;
+    uint8_t oldest = (chart_head + CHART_SAMPLES - chart_count) % CHART_SAMPLES;
+    uint8_t has_prev = (index != oldest);
+
+    for (uint8_t b = 0; b < CHART_BANDS; b++) {
+        uint8_t level = chart_level[index][b];
+        if (level == CHART_INVALID) continue;
+
+        uint8_t bottom = b * (CHART_BAND_HEIGHT + CHART_BAND_GAP) + CHART_BAND_HEIGHT - 1;
+        uint8_t y = bottom - level;
+        uint8_t y_prev = y;
+        if (has_prev && chart_level[prev][b] != CHART_INVALID) {
+            y_prev = bottom - chart_level[prev][b];
+        }
+        Chart_SetSpan(column, y, y_prev);
+    }
+    OLED_DrawColumn(index, column);
+}
+
+/**
+  * @brief  清空光标列
+  */
+static void Chart_DrawCursor(void)
+{
+    static const uint8_t blank[8] = {0};
+    OLED_DrawColumn(chart_head, blank);
+}
+
+/**
+  * @brief  曲线模块初始化
+  */
+void Chart_Init(void)
+{
+    chart_head = 0;
+    chart_count = 0;
+}
+
+/**
+  * @brief  记录一个采样
+  * @param  light: 光照百分比 0~100
+  * @param  speed: 车速 cm/s
+  * @param  distance: 距离 cm，负数表示无效
+  * @param  draw: 曲线页正在显示时为 1，只改写新采样所在列和光标列
+  */
+void Chart_AddSample(uint8_t light, uint32_t speed, float distance, uint8_t draw)
+{
+    uint8_t index = chart_head;
+
+    chart_level[index][0] = Chart_Scale(light, 100);
+    chart_level[index][1] = Chart_Scale(speed, CHART_SPEED_MAX);
+    chart_level[index][2] = (distance < 0) ? CHART_INVALID :
+                            Chart_Scale((uint32_t)distance, CHART_DISTANCE_MAX);
+
+    chart_head = (chart_head + 1) % CHART_SAMPLES;
+    if (chart_count < CHART_SAMPLES) chart_count++;
+
+    if (draw) {
+        Chart_DrawSample(index);
+        Chart_DrawCursor();
+    }
+}
+
+/**
+  * @brief  整屏重画曲线页（切换到曲线页或被其他界面覆盖后调用）
+  */
+void Chart_Redraw(void)
+{
+    OLED_Clear();
+    for (uint8_t i = 0; i < chart_count; i++) {
+        Chart_DrawSample((chart_head + CHART_SAMPLES - chart_count + i) % CHART_SAMPLES);
+    }
+    Chart_DrawCursor();
+}
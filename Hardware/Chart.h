@@ -0,0 +1,18 @@
+/*==============================================================================
+  文件：Chart.h
+  功能：OLED 传感器历史曲线页（光照/车速/距离，最近 128 个采样）
+==============================================================================*/
+#ifndef __CHART_H
+#define __CHART_H
+
+#include <stdint.h>
+
+#define CHART_SAMPLES       128     // 历史深度，与屏幕列数一致
+#define CHART_SPEED_MAX     200     // 车速满量程 cm/s
+#define CHART_DISTANCE_MAX  200     // 距离满量程 cm
+
+void Chart_Init(void);
+void Chart_AddSample(uint8_t light, uint32_t speed, float distance, uint8_t draw);
+void Chart_Redraw(void);
+
+#endif // __CHART_H
@@ -4,12 +4,14 @@
 ==============================================================================*/
 #include "stm32f10x.h"
 #include "stm32f10x_flash.h"
-#include <stdio.h>
-#include <string.h>
 #include "Delay.h"
 #include "OLED.h"
 #include "Config.h"
 #include "KeyEXTI.h"
+#include "Format.h"
+#include "Screen.h"
+#include "Trace.h"
+#include "Overlay.h"
 
 // 首次进入标志
 uint8_t first_entry_flag = 1;
@@ -29,8 +31,6 @@ static uint8_t currentParamIndex = 0;
 static uint8_t blinkState = 0;
 static uint32_t lastBlinkTime = 0;
 static uint32_t configStartTime = 0;
-static uint8_t displayOffset = 0;
-static uint8_t display_initialized = 0;
 
 // 临时参数数组
 static uint8_t tempParamValues[PARAM_COUNT];
@@ -45,6 +45,7 @@ static ParamConfig_t params[PARAM_COUNT] = {
 
 // 外部函数声明
 extern void Redraw_OLED_Labels(void);
+extern void Persist_RequestSave(uint8_t source);
 
 /**
   * @brief  配置模块初始化
@@ -68,14 +69,11 @@ void Config_EnterConfigMode(void)
     configStartTime = 0;
     blinkState = 0;
     lastBlinkTime = 0;
-    displayOffset = 0;
-    display_initialized = 0;
     
     for (uint8_t i = 0; i < PARAM_COUNT; i++) {
         tempParamValues[i] = params[i].value;
     }
     
-    OLED_Clear();
     first_entry_flag = 1;
 }
 
@@ -85,8 +83,7 @@ void Config_EnterConfigMode(void)
 void Config_ExitConfigMode(void)
 {
     inConfigMode = 0;
-    OLED_Clear();
-    // 退出配置模式后重新绘制主界面标签
+    // 退出配置模式后重新绘制主界面标签（有提示时推迟到提示结束）
     Redraw_OLED_Labels();
 }
 
@@ -141,7 +138,6 @@ void Config_HandleKeys(void)
                 
             case KEY3_PRES:  // 下一参数
                 currentParamIndex = (currentParamIndex + 1) % PARAM_COUNT;
-                first_entry_flag = 1;
                 break;
                 
             default:
@@ -193,7 +189,6 @@ void Config_HandleKeys(void)
             
             if (current_time - last_switch_time >= 200) {  // 每200ms切换一次
                 currentParamIndex = (currentParamIndex + 1) % PARAM_COUNT;
-                first_entry_flag = 1;
                 last_switch_time = current_time;
                 configStartTime = 0;
             }
@@ -202,136 +197,69 @@ void Config_HandleKeys(void)
 }
 
 /**
-  * @brief  更新配置界面显示
+  * @brief  配置界面字段格式化
+  */
+static uint8_t Fmt_Cursor(char *buf, const void *src)
+{
+    uint8_t row = *(const uint8_t *)src;
+    return Format_Str(buf, (row == currentParamIndex && blinkState) ? ">" : " ");
+}
+
+static uint8_t Fmt_ParamName(char *buf, const void *src)
+{
+    uint8_t len = Format_Str(buf, ((const ParamConfig_t *)src)->name);
+    return len + Format_Str(buf + len, " =");
+}
+
+static uint8_t Fmt_ParamValue(char *buf, const void *src)
+{
+    return Format_UInt(buf, *(const uint8_t *)src, 3);
+}
+
+static uint8_t Fmt_ParamSymbol(char *buf, const void *src)
+{
+    buf[0] = params[*(const uint8_t *)src].symbol;
+    buf[1] = '\0';
+    return 1;
+}
+
+static const uint8_t paramRows[PARAM_COUNT] = {0, 1, 2, 3};
+
+// 配置界面：每行 "> LUX =  60 lx"，右下角为当前参数字母
+#define CONFIG_ROW(i, unit) \
+    {(i) + 1, 1, 1, Fmt_Cursor,     &paramRows[i],       0   }, \
+    {(i) + 1, 3, 6, Fmt_ParamName,  &params[i],          0   }, \
+    {(i) + 1, 9, 4, Fmt_ParamValue, &tempParamValues[i], unit}
+
+static const ScreenField_t configScreen[] = {
+    CONFIG_ROW(PARAM_LUX, "lx"),
+    CONFIG_ROW(PARAM_SPD, "cm/s"),
+    CONFIG_ROW(PARAM_DIS, "cm"),
+    CONFIG_ROW(PARAM_HUM, "%"),
+    {4, 16, 1, Fmt_ParamSymbol, &currentParamIndex, 0},
+};
+
+/**
+  * @brief  更新配置界面显示（按字段表渲染，只重画变化的字符）
   */
 void Config_UpdateDisplay(void)
 {
-    static uint8_t first_entry = 1;
-    static uint8_t last_values[PARAM_COUNT] = {0};
-    static uint8_t last_param_index = 0xFF;
-    static uint8_t last_blink_state = 0xFF;
-    
-    if (first_entry_flag) {
-        first_entry = 1;
-        first_entry_flag = 0;
-    }
-    
-    if (!display_initialized) {
-        OLED_Clear();
-        display_initialized = 1;
-        first_entry = 1;
-    }
-    
-    if (first_entry) {
-        first_entry = 0;
-        OLED_Clear();
-        
-        uint8_t displayLines = (PARAM_COUNT < 5) ? PARAM_COUNT : 4;
-        
-        for (uint8_t i = 0; i < displayLines; i++) {
-            uint8_t paramIdx = i + displayOffset;
-            if (paramIdx >= PARAM_COUNT) break;
-            
-            char unit[10] = "";
-            switch (paramIdx) {
-                case PARAM_LUX:  strcpy(unit, "lx"); break;
-                case PARAM_SPD:  strcpy(unit, "cm/s"); break;
-                case PARAM_DIS:  strcpy(unit, "cm"); break;
-                case PARAM_HUM:  strcpy(unit, "%"); break;
-                default: break;
-            }
-            
-            char buf[20];
-            sprintf(buf, "%s = %3d %s", params[paramIdx].name, 
-                    tempParamValues[paramIdx], unit);
-            OLED_ShowString(i + 1, 3, buf);
-        }
-        
-        uint8_t row = currentParamIndex - displayOffset + 1;
-        if (row >= 1 && row <= 4) {
-            OLED_ShowString(row, 1, ">");
-        }
-        
-        OLED_ShowChar(4, 16, params[currentParamIndex].symbol);
-        
-        for (uint8_t i = 0; i < PARAM_COUNT; i++) {
-            last_values[i] = tempParamValues[i];
-        }
-        last_param_index = currentParamIndex;
-        last_blink_state = blinkState;
-        return;
-    }
-    
     // 闪烁处理
     uint32_t currentTime = GetTick();
     if (currentTime - lastBlinkTime >= 200) {
         blinkState = !blinkState;
         lastBlinkTime = currentTime;
     }
-    
-    // 参数索引变化时更新
-    if (last_param_index != currentParamIndex) {
-        uint8_t old_row = last_param_index - displayOffset + 1;
-        if (old_row >= 1 && old_row <= 4) {
-            OLED_ShowString(old_row, 1, " ");
-        }
-        
-        if (currentParamIndex < displayOffset || currentParamIndex >= displayOffset + 4) {
-            displayOffset = (currentParamIndex / 4) * 4;
-            first_entry = 1;
-            Config_UpdateDisplay();
-            return;
-        }
-        
-        uint8_t row = currentParamIndex - displayOffset + 1;
-        if (row >= 1 && row <= 4) {
-            if (blinkState) {
-                OLED_ShowString(row, 1, ">");
-            } else {
-                OLED_ShowString(row, 1, " ");
-            }
-        }
-        
-        OLED_ShowChar(4, 16, params[currentParamIndex].symbol);
-        last_param_index = currentParamIndex;
-    }
-    
-    // 数值变化时更新
-    for (uint8_t i = 0; i < PARAM_COUNT; i++) {
-        if (last_values[i] != tempParamValues[i]) {
-            if (i >= displayOffset && i < displayOffset + 4) {
-                uint8_t row = i - displayOffset + 1;
-                char buf[4];
-                sprintf(buf, "%3d", tempParamValues[i]);
-                char unit_buf[20];
-                char unit[10] = "";
-                switch (i) {
-                    case PARAM_LUX:  strcpy(unit, "lx"); break;
-                    case PARAM_SPD:  strcpy(unit, "cm/s"); break;
-                    case PARAM_DIS:  strcpy(unit, "cm"); break;
-                    case PARAM_HUM:  strcpy(unit, "%"); break;
-                    default: break;
-                }
-                sprintf(unit_buf, "%3d %s", tempParamValues[i], unit);
-                OLED_ShowString(row, 7, "      ");
-                OLED_ShowString(row, 7, unit_buf);
-            }
-            last_values[i] = tempParamValues[i];
-        }
-    }
-    
-    // 闪烁状态变化时更新
-    if (last_blink_state != blinkState) {
-        uint8_t row = currentParamIndex - displayOffset + 1;
-        if (row >= 1 && row <= 4 && (currentParamIndex >= displayOffset && currentParamIndex < displayOffset + 4)) {
-            if (blinkState) {
-                OLED_ShowString(row, 1, ">");
-            } else {
-                OLED_ShowString(row, 1, " ");
-            }
-        }
-        last_blink_state = blinkState;
+
+    // 提示显示期间不绘制，提示结束后整屏重画
+    if (Overlay_IsActive()) return;
+
+    if (first_entry_flag) {
+        first_entry_flag = 0;
+        Screen_Clear();
     }
+
+    Screen_Render(configScreen, SCREEN_FIELD_COUNT(configScreen));
 }
 
 /**
@@ -365,6 +293,7 @@ uint8_t Config_SaveParams(void)
     uint32_t data;
     uint8_t success = 1;
     
+    TRACE_BEGIN(TRACE_FLASH, 0);
     FLASH_Unlock();
     FLASH_ClearFlag(FLASH_FLAG_BSY | FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPRTERR);
     
@@ -406,6 +335,7 @@ uint8_t Config_SaveParams(void)
     
 end:
     FLASH_Lock();
+    TRACE_END(TRACE_FLASH, success);
     return success;
 }
 
@@ -484,19 +414,10 @@ void Config_ProcessTimeout(void)
              configStartTime++;
         }
 
-        if (configStartTime >= 40) {  // 20秒超时
-            Config_CommitTempParams();
-            if (Config_SaveParams()) {
-                OLED_Clear();
-                OLED_ShowString(3, 1, "AUTO SAVE OK");
-                Delay_ms(1000);
-            } else {
-                OLED_Clear();
-                OLED_ShowString(3, 1, "AUTO SAVE FAIL");
-                Delay_ms(1000);
-            }
+        if (inConfigMode && configStartTime >= 40) {  // 20秒超时
+            // 写 Flash 交给存储线程，结果由界面线程显示
+            Persist_RequestSave(SAVE_SOURCE_AUTO);
             Config_ExitConfigMode();
-            // 这里会自动调用Redraw_OLED_Labels()
         }
     }
 }
@@ -4,13 +4,15 @@
 ==============================================================================*/
 #ifndef __CONFIG_H
 #define __CONFIG_H
-#include <stdio.h>  // 添加这一行以使用sprintf
-
 #include <stdint.h>
 
 // 首次进入标志
 extern uint8_t first_entry_flag;
 
+// 保存请求来源（Persist_RequestSave）
+#define SAVE_SOURCE_MANUAL  0   // KEY4长按保存
+#define SAVE_SOURCE_AUTO    1   // 配置超时自动保存
+
 // 参数类型定义 - 仅保留四个需要的参数
 typedef enum {
     PARAM_LUX = 0,    // 光照阈值
@@ -3,9 +3,15 @@
 ==============================================================================*/
 #include "stm32f10x.h"
 #include "CountSensor.h"
+#include "Timebase.h"
+#include "Event.h"
+#include "Prof.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
 
 static volatile uint16_t CountSensor_Count = 0;
-static volatile uint32_t Last_Pulse_Time = 0;  // 记录最后一次脉冲时间
+static volatile uint32_t Last_Pulse_Time = 0;  // 最后一次脉冲时间戳（us）
+static uint16_t Pending_Pulses = 0;            // 队列满未投递的脉冲数，下次随同投递
 
 /**
   * @brief  计数传感器初始化 (PA5)
@@ -30,17 +36,16 @@ void CountSensor_Init(void)
     EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
     EXTI_Init(&EXTI_InitStructure);
 
-    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
-
     NVIC_InitTypeDef NVIC_InitStructure;
     NVIC_InitStructure.NVIC_IRQChannel                   = EXTI9_5_IRQn;
     NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIO_WHEEL;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = IRQ_SUBPRIO_DEFAULT;
     NVIC_Init(&NVIC_InitStructure);
 
     CountSensor_Count = 0;
     Last_Pulse_Time = 0;
+    Pending_Pulses = 0;
 }
 
 /**
@@ -52,7 +57,7 @@ uint16_t CountSensor_Get(void)
 }
 
 /**
-  * @brief  获取最后一次脉冲的时间戳
+  * @brief  获取最后一次脉冲的时间戳（us，Time_Us 时基）
   */
 uint32_t CountSensor_GetLastPulseTime(void)
 {
@@ -73,6 +78,8 @@ void CountSensor_Reset(void)
   */
 void EXTI9_5_IRQHandler(void)
 {
+    ISR_ENTER(ISR_EXTI9_5, ISR_LATENCY_NONE);
+    PROF_BEGIN(PROF_EXTI9_5_IRQ);
     if (EXTI_GetITStatus(EXTI_Line5) == SET)
     {
         // 简单消抖：检测引脚状态
@@ -81,10 +88,17 @@ void EXTI9_5_IRQHandler(void)
             if (CountSensor_Count > 9999) {
                 CountSensor_Count = 0;
             }
-            // 记录脉冲时间戳（使用SysTick）
-            Last_Pulse_Time = SysTick->VAL;
+            // 记录脉冲时间戳（us）
+            Last_Pulse_Time = Time_Us();
+            // 投递脉冲事件；队列满时累积，下一次成功投递时一起计入
+            Pending_Pulses++;
+            if (Event_Post(EVENT_WHEEL, 0, Pending_Pulses)) {
+                Pending_Pulses = 0;
+            }
         }
         
         EXTI_ClearITPendingBit(EXTI_Line5);
     }
+    PROF_END(PROF_EXTI9_5_IRQ);
+    ISR_EXIT(ISR_EXTI9_5);
 }
@@ -0,0 +1,193 @@
+/*==============================================================================
+  文件：Diag.c
+  功能：OLED 诊断页，8 行 x 21 列（6x8 字体）
+        抖动页（单位 us）：
+          第 1~3 行：周期最小/最大/平均、释放延迟最大值、响应时间最大值与超时次数
+          第 4~8 行：响应时间直方图，每行两档，标签为该档上限（由 Jitter_BucketLimit 生成）
+          自动模式下短按 KEY2 清零，便于改动后重新统计
+        中断页（单位 CPU 周期）：
+          第 1 行表头，之后每个中断一行：名称、抢占优先级、最大进入延迟、最大执行时间；
+          无法测量进入延迟的显示 ----；最后是最大嵌套深度与主栈历史最大用量（字节）
+        线程页：
+          第 1 行表头，之后每个线程一行：名称、优先级、状态（R 就绪 / S 延时 / B 阻塞）、
+          栈余量/栈大小（字节）；最后一行是最近一次与最大的 PendSV 切换周期数
+==============================================================================*/
+#include "stm32f10x.h"
+#include "OLED.h"
+#include "Format.h"
+#include "Jitter.h"
+#include "IsrStat.h"
+#include "Kernel.h"
+#include "Diag.h"
+
+#define DIAG_VALUE_WIDTH   5
+#define DIAG_VALUE_MAX     99999    // 超出 5 位按上限显示
+#define DIAG_THREAD_ROWS   6        // 线程页第 2~7 行
+
+/**
+  * @brief  追加 "名称 数值"，数值右对齐 5 位
+  */
+static uint8_t Diag_AppendField(char *buf, const char *name, uint32_t value)
+{
+    uint8_t n = Format_Str(buf, name);
+    if (value > DIAG_VALUE_MAX) value = DIAG_VALUE_MAX;
+    return n + Format_UInt(buf + n, value, DIAG_VALUE_WIDTH);
+}
+
+/**
+  * @brief  直方图标签：该档上限（不足 1ms 以 u 结尾，否则以 m 结尾），最后一档为 ">" + 上一档上限
+  */
+static uint8_t Diag_AppendBucketLabel(char *buf, uint8_t bucket)
+{
+    uint32_t limit = Jitter_BucketLimit(bucket);
+    uint8_t n = 0;
+
+    if (limit == 0) {
+        buf[n++] = '>';
+        limit = Jitter_BucketLimit(bucket - 1);
+    }
+    if (limit >= 1000) {
+        n += Format_UInt(buf + n, limit / 1000, 0);
+        buf[n++] = 'm';
+    } else {
+        n += Format_UInt(buf + n, limit, 0);
+        buf[n++] = 'u';
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/**
+  * @brief  直方图一档：标签左对齐 4 列 + 计数 5 位
+  */
+static uint8_t Diag_AppendBucket(char *buf, uint8_t bucket, uint32_t count)
+{
+    uint8_t n = Diag_AppendBucketLabel(buf, bucket);
+    while (n < 4) buf[n++] = ' ';
+    if (count > DIAG_VALUE_MAX) count = DIAG_VALUE_MAX;
+    return n + Format_UInt(buf + n, count, DIAG_VALUE_WIDTH);
+}
+
+/**
+  * @brief  抖动页
+  */
+static void Diag_UpdateJitter(void)
+{
+    Jitter_Stats_t s;
+    char line[24];
+    uint8_t n;
+
+    Jitter_GetStats(&s);
+
+    n = Diag_AppendField(line, "Pmin ", s.period_min);
+    Diag_AppendField(line + n, " Pmax ", s.period_max);
+    OLED_ShowString6x8(1, 1, line);
+
+    n = Diag_AppendField(line, "Pavg ", s.period_mean);
+    Diag_AppendField(line + n, " Lmax ", s.latency_max);
+    OLED_ShowString6x8(2, 1, line);
+
+    n = Diag_AppendField(line, "Rmax ", s.response_max);
+    Diag_AppendField(line + n, " miss ", s.misses);
+    OLED_ShowString6x8(3, 1, line);
+
+    for (uint8_t row = 0; row < JITTER_BUCKETS / 2; row++) {
+        n = Diag_AppendBucket(line, row * 2, s.histogram[row * 2]);
+        line[n++] = ' ';
+        Diag_AppendBucket(line + n, row * 2 + 1, s.histogram[row * 2 + 1]);
+        OLED_ShowString6x8(4 + row, 1, line);
+    }
+}
+
+/**
+  * @brief  中断页
+  */
+static void Diag_UpdateIsr(void)
+{
+    IsrStat_t s;
+    char line[24];
+    uint8_t n;
+
+    OLED_ShowString6x8(1, 1, "IRQ  P   Lcyc   Dcyc");
+    for (uint8_t i = 0; i < ISR_COUNT; i++) {
+        IsrStat_Get((IsrStat_Id_t)i, &s);
+        n = Format_Str(line, IsrStat_GetName((IsrStat_Id_t)i));
+        line[n++] = ' ';
+        n += Format_UInt(line + n, IsrStat_GetPriority((IsrStat_Id_t)i), 1);
+        if (s.latency_max == ISR_LATENCY_NONE) {
+            n += Format_Invalid(line + n, 7);
+        } else {
+            n += Format_UInt(line + n, s.latency_max > DIAG_VALUE_MAX ? DIAG_VALUE_MAX : s.latency_max, 7);
+        }
+        Format_UInt(line + n, s.duration_max > DIAG_VALUE_MAX ? DIAG_VALUE_MAX : s.duration_max, 7);
+        OLED_ShowString6x8(2 + i, 1, line);
+    }
+
+    n = Format_Str(line, "Nest ");
+    n += Format_UInt(line + n, IsrStat_GetMaxNesting(), 1);
+    n += Format_Str(line + n, " MSP ");
+    n += Format_UInt(line + n, IsrStat_GetMspUsed(), 5);
+    n += Format_Str(line + n, "/");
+    Format_UInt(line + n, MSP_STACK_SIZE, 4);
+    OLED_ShowString6x8(2 + ISR_COUNT, 1, line);
+}
+
+/**
+  * @brief  线程页
+  */
+static void Diag_UpdateKernel(void)
+{
+    static const char state_chars[] = "RSB";
+    const Kernel_Thread_t *t;
+    char line[24];
+    uint8_t n;
+
+    OLED_ShowString6x8(1, 1, "THR  P S  Free  Size");
+    for (uint8_t i = 0; i < DIAG_THREAD_ROWS && (t = Kernel_GetThread(i)) != 0; i++) {
+        n = Format_Str(line, t->name);
+        while (n < 5) line[n++] = ' ';
+        n += Format_UInt(line + n, t->priority, 1);
+        line[n++] = ' ';
+        line[n++] = t->state < 3 ? state_chars[t->state] : '?';
+        n += Format_UInt(line + n, Kernel_GetStackFree(t), 6);
+        Format_UInt(line + n, t->stack_words * 4, 6);
+        OLED_ShowString6x8(2 + i, 1, line);
+    }
+
+    n = Diag_AppendField(line, "Sw   ", Kernel_GetSwitchCycles());
+    Diag_AppendField(line + n, " max ", Kernel_GetMaxSwitchCycles());
+    OLED_ShowString6x8(8, 1, line);
+}
+
+void Diag_Redraw(uint8_t view)
+{
+    OLED_Clear();
+    Diag_Update(view);
+}
+
+/**
+  * @brief  清零视图对应的统计（抖动页：下一个控制周期开始时生效）
+  * @retval 1 已清零，0 该视图没有可清零的统计
+  */
+uint8_t Diag_Reset(uint8_t view)
+{
+    if (view == DIAG_VIEW_JITTER) {
+        Jitter_Reset();
+        return 1;
+    }
+    return 0;
+}
+
+/**
+  * @brief  刷新诊断页全部数值（写入显存，由空闲推送）
+  */
+void Diag_Update(uint8_t view)
+{
+    if (view == DIAG_VIEW_ISR) {
+        Diag_UpdateIsr();
+    } else if (view == DIAG_VIEW_KERNEL) {
+        Diag_UpdateKernel();
+    } else {
+        Diag_UpdateJitter();
+    }
+}
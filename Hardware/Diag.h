@@ -0,0 +1,22 @@
+/*==============================================================================
+  文件：Diag.h
+  功能：OLED 诊断页（6x8 小字体）
+        DIAG_VIEW_JITTER：控制周期抖动、响应时间直方图与超时次数
+        DIAG_VIEW_ISR：各中断优先级、最大进入延迟/执行时间、嵌套深度、主栈用量
+        DIAG_VIEW_KERNEL：各线程优先级、状态、栈余量，PendSV 切换周期数
+==============================================================================*/
+#ifndef __DIAG_H
+#define __DIAG_H
+
+#include <stdint.h>
+
+#define DIAG_VIEW_JITTER    0
+#define DIAG_VIEW_ISR       1
+#define DIAG_VIEW_KERNEL    2
+#define DIAG_VIEW_COUNT     3
+
+void Diag_Redraw(uint8_t view);
+void Diag_Update(uint8_t view);
+uint8_t Diag_Reset(uint8_t view);
+
+#endif // __DIAG_H
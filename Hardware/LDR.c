@@ -1,5 +1,7 @@
 // LDR.c
 #include "LDR.h"
+#include "Prof.h"
+#include "Trace.h"
 
 // ???? + ADC ???
 void LDR_Init(void)
@@ -35,10 +37,15 @@ uint16_t LDR_Average_Data(void)
 // ? ADC ????????(Lux)
 uint16_t LDR_LuxData(void)
 {
+    PROF_BEGIN(PROF_LDR_LUX);
+    TRACE_BEGIN(TRACE_LDR, 0);
     float voltage = LDR_Average_Data() * (3.3f / 4096.0f);
     float R = voltage / (3.3f - voltage) * 10000.0f;
     uint16_t lux = (uint16_t)(40000.0f * powf(R, -0.6021f));
-    return (lux > 999 ? 999 : lux);
+    if (lux > 999) lux = 999;
+    TRACE_END(TRACE_LDR, lux);
+    PROF_END(PROF_LDR_LUX);
+    return lux;
 }
 
 // ? 0~999 Lux ????? 0~100%,????????
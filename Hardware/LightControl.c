@@ -7,6 +7,10 @@
 #include "Delay.h"
 #include "Config.h"
 #include "OLED.h"
+#include "Overlay.h"
+#include "Prof.h"
+#include "dht11.h"
+#include "Kernel.h"
 
 // 控制模式定义
 #define LIGHT_MODE_AUTO     0
@@ -36,6 +40,7 @@
 // 距离 (cm)
 #define DISTANCE_CLOSE      20
 #define DISTANCE_FAR        50
+#define DISTANCE_NONE       1000    // 前方无障碍时代入的距离
 
 // 环境值
 #define LIGHT_DARK_THRESHOLD   20
@@ -61,6 +66,10 @@ static uint16_t tunnelTimer = 0;
 
 // 函数声明
 void Redraw_OLED_Labels(void);
+void Display_NextPage(void);
+void Display_ResetStats(void);
+void LightControl_SetMode(uint8_t mode);
+void Persist_RequestSave(uint8_t source);
 
 /**
   * @brief  灯光控制系统初始化
@@ -209,6 +218,27 @@ static uint8_t CheckFogLight(uint8_t temp, uint8_t humidity)
     return 0;
 }
 
+/**
+  * @brief  切换控制模式并关闭灯光、清零平滑与手动状态（界面线程调用）
+  *         控制线程优先级更高，切换在 Kernel_Lock 内完成，
+  *         LightControl_Update 不会看到新模式与旧的 PWM/平滑状态混在一起
+  */
+static void SwitchMode(uint8_t mode)
+{
+    Kernel_Lock();
+    lightMode = mode;
+    prevLowBeamDuty = 0;
+    prevHighBeamDuty = 0;
+    fogLightState = 0;
+    manualHighBeamState = 0;
+    manualLowBeamState = 0;
+    manualFogLightState = 0;
+    PWM_SetCompare2(0);
+    PWM_SetCompare3(0);
+    PWM_SetCompare4(0);
+    Kernel_Unlock();
+}
+
 /**
   * @brief  处理按键输入
   */
@@ -235,6 +265,8 @@ static void HandleKeyInput(void)
                     manualLowBeamState = !manualLowBeamState;
                     PWM_SetCompare3(manualLowBeamState ? LOW_BEAM_LEVEL3 : 0);
                     prevLowBeamDuty = manualLowBeamState ? LOW_BEAM_LEVEL3 : 0;
+                } else {
+                    Display_ResetStats();   // 自动模式下清零诊断页统计
                 }
                 break;
 
@@ -248,40 +280,11 @@ static void HandleKeyInput(void)
 
             case KEY4_PRES:
                 if (lightMode == LIGHT_MODE_AUTO) {
-                    lightMode = LIGHT_MODE_MANUAL;
-                    OLED_Clear();
-                    OLED_ShowString(2, 4, "MANUAL MODE");
-                    Delay_ms(800);
-                    OLED_Clear();
-                    Redraw_OLED_Labels();  // 重新绘制标签
-                    
-                    manualHighBeamState = 0;
-                    manualLowBeamState = 0;
-                    manualFogLightState = 0;
-                    PWM_SetCompare2(0);
-                    PWM_SetCompare3(0);
-                    PWM_SetCompare4(0);
-                    prevLowBeamDuty = 0;
-                    prevHighBeamDuty = 0;
-                    fogLightState = 0;
-                    
+                    SwitchMode(LIGHT_MODE_MANUAL);
+                    Overlay_Show(2, 4, "MANUAL MODE", 800);  // 结束后自动重绘界面
                 } else if (lightMode == LIGHT_MODE_MANUAL) {
-                    lightMode = LIGHT_MODE_AUTO;
-                    OLED_Clear();
-                    OLED_ShowString(2, 4, "AUTO MODE");
-                    Delay_ms(800);
-                    OLED_Clear();
-                    Redraw_OLED_Labels();  // 重新绘制标签
-                    
-                    manualHighBeamState = 0;
-                    manualLowBeamState = 0;
-                    manualFogLightState = 0;
-                    PWM_SetCompare2(0);
-                    PWM_SetCompare3(0);
-                    PWM_SetCompare4(0);
-                    prevLowBeamDuty = 0;
-                    prevHighBeamDuty = 0;
-                    fogLightState = 0;
+                    SwitchMode(LIGHT_MODE_AUTO);
+                    Overlay_Show(2, 4, "AUTO MODE", 800);  // 结束后自动重绘界面
                 }
                 break;
 
@@ -289,53 +292,31 @@ static void HandleKeyInput(void)
                 break;
         }
     }
+
+    // KEY3长按切换显示页面（数值/历史曲线）
+    if (KeyEXTI_GetLongPress(3)) {
+        Display_NextPage();
+    }
 }
 
 /**
-  * @brief  更新灯光控制逻辑
+  * @brief  处理按键、模式切换与配置界面（界面线程调用）
   */
-void LightControl_Update(uint8_t light, uint32_t speed, float distance, uint8_t temp, uint8_t humidity)
+void LightControl_HandleInput(void)
 {
     // 处理长按事件
     if (KeyEXTI_GetLongPress(1) && lightMode == LIGHT_MODE_AUTO) {
         lightMode = LIGHT_MODE_CONFIG;
         Config_EnterConfigMode();
-        OLED_Clear();
-        OLED_ShowString(2, 4, "CONFIG MODE");
-        Delay_ms(500);
+        Overlay_Show(2, 4, "CONFIG MODE", 500);
         return;
     }
     
     if (KeyEXTI_GetLongPress(4) && lightMode == LIGHT_MODE_CONFIG) {
-        Config_CommitTempParams();
-        uint8_t save_result = Config_SaveParams();
-        
-        OLED_Clear();
-        if (save_result) {
-            OLED_ShowString(2, 5, "SAVE OK");
-        } else {
-            OLED_ShowString(2, 4, "SAVE FAIL");
-        }
-        Delay_ms(1000);
-        
+        // 写 Flash 交给存储线程，结果由界面线程显示
+        Persist_RequestSave(SAVE_SOURCE_MANUAL);
         Config_ExitConfigMode();
-        lightMode = LIGHT_MODE_AUTO;
-        
-        prevLowBeamDuty = 0;
-        prevHighBeamDuty = 0;
-        fogLightState = 0;
-        manualHighBeamState = 0;
-        manualLowBeamState = 0;
-        manualFogLightState = 0;
-        PWM_SetCompare2(0);
-        PWM_SetCompare3(0);
-        PWM_SetCompare4(0);
-        
-        OLED_Clear();
-        OLED_ShowString(2, 4, "AUTO MODE");
-        Delay_ms(500);
-        OLED_Clear();
-        Redraw_OLED_Labels();  // 重新绘制标签
+        LightControl_SetMode(LIGHT_MODE_AUTO);
         return;
     }
     
@@ -343,11 +324,28 @@ void LightControl_Update(uint8_t light, uint32_t speed, float distance, uint8_t
         Config_HandleKeys();
         Config_UpdateDisplay();
         Config_ProcessTimeout();
+        // 配置超时自动保存后回到自动模式
+        if (!Config_IsInConfigMode()) {
+            LightControl_SetMode(LIGHT_MODE_AUTO);
+        }
         return;
     }
 
     HandleKeyInput();
-    
+}
+
+/**
+  * @brief  更新灯光控制逻辑（控制线程按固定周期调用）
+  * @param  climate: 温湿度缓存，失效时雾灯保持当前状态
+  */
+void LightControl_Update(uint8_t light, uint32_t speed, float distance, const DHT11_Sample_t *climate)
+{
+    if (lightMode == LIGHT_MODE_CONFIG) {
+        return;
+    }
+
+    PROF_BEGIN(PROF_LIGHT_UPDATE);
+    if (distance < 0) distance = DISTANCE_NONE;   // 超声滤波输出无障碍
     DetectLightChange(light);
 
     if (lightMode == LIGHT_MODE_AUTO) {
@@ -357,12 +355,14 @@ void LightControl_Update(uint8_t light, uint32_t speed, float distance, uint8_t
         uint16_t highBeamTarget = CalculateHighBeam(light, speed, distance);
         prevHighBeamDuty = ExponentialSmoothPWM(2, highBeamTarget, prevHighBeamDuty, 15);
 
-        uint8_t fogTarget = CheckFogLight(temp, humidity);
+        uint8_t fogTarget = climate->valid ?
+                            CheckFogLight(climate->temperature, climate->humidity) : fogLightState;
         if (fogTarget != fogLightState) {
             fogLightState = fogTarget;
             PWM_SetCompare4(fogLightState ? 100 : 0);
         }
     }
+    PROF_END(PROF_LIGHT_UPDATE);
 }
 
 /**
@@ -379,21 +379,10 @@ uint8_t LightControl_GetMode(void)
 void LightControl_SetMode(uint8_t mode)
 {
     if (mode <= LIGHT_MODE_CONFIG) {
-        lightMode = mode;
-        
-        prevLowBeamDuty = 0;
-        prevHighBeamDuty = 0;
-        fogLightState = 0;
-        manualHighBeamState = 0;
-        manualLowBeamState = 0;
-        manualFogLightState = 0;
-        PWM_SetCompare2(0);
-        PWM_SetCompare3(0);
-        PWM_SetCompare4(0);
+        SwitchMode(mode);
         
         if (mode != LIGHT_MODE_CONFIG) {
-            OLED_Clear();
-            Redraw_OLED_Labels();  // 重新绘制标签
+            Redraw_OLED_Labels();  // 重新绘制标签（有提示时推迟到提示结束）
         }
     }
 }
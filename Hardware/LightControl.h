@@ -6,6 +6,7 @@
 #define __LIGHT_CONTROL_H
 
 #include <stdint.h>
+#include "dht11.h"
 
 // ??????
 #define LIGHT_MODE_AUTO     0   // ????
@@ -44,7 +45,8 @@
 
 // ????
 void LightControl_Init(void);
-void LightControl_Update(uint8_t light, uint32_t speed, float distance, uint8_t temp, uint8_t humidity);
+void LightControl_Update(uint8_t light, uint32_t speed, float distance, const DHT11_Sample_t *climate);
+void LightControl_HandleInput(void);
 uint8_t LightControl_GetMode(void);
 void LightControl_SetMode(uint8_t mode);
 
@@ -1,9 +1,433 @@
 #include "stm32f10x.h"
+#include "OLED.h"
 #include "OLED_Font.h"
+#include "OLED_Font6x8.h"
+#include "Prof.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
+#include "Trace.h"
 
-/*引脚配置*/
-#define OLED_W_SCL(x)		GPIO_WriteBit(GPIOB, GPIO_Pin_1, (BitAction)(x))
-#define OLED_W_SDA(x)		GPIO_WriteBit(GPIOB, GPIO_Pin_0, (BitAction)(x))
+#if OLED_USE_HW_I2C
+/*硬件I2C2引脚：PB10=SCL，PB11=SDA；DMA1通道4为I2C2_TX*/
+#define OLED_I2C					I2C2
+#define OLED_I2C_SPEED				400000
+#define OLED_DMA_CHANNEL			DMA1_Channel4
+#define OLED_DMA_IT_TC				DMA1_IT_TC4
+#define OLED_DMA_IT_GL				DMA1_IT_GL4
+#define OLED_HW_TIMEOUT				20000
+
+/*显存操作与中断刷新互斥*/
+#define OLED_ENTER_CRITICAL()		uint32_t OLED_Primask = __get_PRIMASK(); __disable_irq()
+#define OLED_EXIT_CRITICAL()		__set_PRIMASK(OLED_Primask)
+#else
+/*引脚配置，直接写BSRR/BRR，不经过库函数*/
+#define OLED_SCL_PIN		GPIO_Pin_1
+#define OLED_SDA_PIN		GPIO_Pin_0
+#define OLED_SCL_H()		(GPIOB->BSRR = OLED_SCL_PIN)
+#define OLED_SCL_L()		(GPIOB->BRR = OLED_SCL_PIN)
+#define OLED_SDA_H()		(GPIOB->BSRR = OLED_SDA_PIN)
+#define OLED_SDA_L()		(GPIOB->BRR = OLED_SDA_PIN)
+
+/*软件I2C时序
+  OLED_I2C_MIN_TIMING = 0（默认）：按SSD1306手册 tLOW>=1.3us、tHIGH>=0.6us 插入延时（约400kHz）；
+  OLED_I2C_MIN_TIMING = 1：超出手册的最短时序（约2.9MHz），SCL高/低电平各只插入OLED_I2C_MIN_LOOPS次
+  空循环（每次约4个时钟），仅在实测某块屏能稳定工作时于工程Define中开启，调试时逐步减小
+  OLED_I2C_MIN_LOOPS直到屏幕刚好稳定，再加回一级作为余量*/
+#ifndef OLED_I2C_MIN_TIMING
+#define OLED_I2C_MIN_TIMING	0
+#endif
+#ifndef OLED_I2C_MIN_LOOPS
+#define OLED_I2C_MIN_LOOPS	2
+#endif
+
+#if OLED_I2C_MIN_TIMING
+#define OLED_I2C_LOW_LOOPS	OLED_I2C_MIN_LOOPS
+#define OLED_I2C_HIGH_LOOPS	OLED_I2C_MIN_LOOPS
+#else
+#define OLED_I2C_LOW_LOOPS	24
+#define OLED_I2C_HIGH_LOOPS	11
+#endif
+
+#define OLED_I2C_DELAY(n)	do {uint8_t d_ = (n); while (d_--) {__NOP();}} while (0)
+
+#define OLED_ENTER_CRITICAL()
+#define OLED_EXIT_CRITICAL()
+#endif
+
+/*初始化命令序列*/
+static const uint8_t OLED_InitCommands[] =
+{
+	0xAE,			//关闭显示
+	0xD5, 0x80,		//设置显示时钟分频比/振荡器频率
+	0xA8, 0x3F,		//设置多路复用率
+	0xD3, 0x00,		//设置显示偏移
+	0x40,			//设置显示开始行
+	0xA1,			//设置左右方向，0xA1正常 0xA0左右反置
+	0xC8,			//设置上下方向，0xC8正常 0xC0上下反置
+	0xDA, 0x12,		//设置COM引脚硬件配置
+	0x81, 0xCF,		//设置对比度控制
+	0xD9, 0xF1,		//设置预充电周期
+	0xDB, 0x30,		//设置VCOMH取消选择级别
+	0xA4,			//设置整个显示打开/关闭
+	0xA6,			//设置正常/倒转显示
+	0x8D, 0x14,		//设置充电泵
+	0xAF,			//开启显示
+};
+
+/*显存缓冲，8页×128列，与SSD1306 GDDRAM一一对应*/
+static uint8_t OLED_DisplayBuf[8][128];
+
+/*每页的脏区范围[DirtyStart, DirtyEnd)，Start >= End 表示该页无需刷新*/
+static uint8_t OLED_DirtyStart[8];
+static uint8_t OLED_DirtyEnd[8];
+
+/**
+  * @brief  标记显存某页的一段列区间需要刷新
+  * @param  Page 页地址，范围：0~7
+  * @param  X0 起始列（含），范围：0~127
+  * @param  X1 结束列（不含），范围：1~128
+  * @retval 无
+  */
+static void OLED_MarkDirty(uint8_t Page, uint8_t X0, uint8_t X1)
+{
+	OLED_ENTER_CRITICAL();
+	if (OLED_DirtyStart[Page] >= OLED_DirtyEnd[Page])
+	{
+		OLED_DirtyStart[Page] = X0;
+		OLED_DirtyEnd[Page] = X1;
+	}
+	else
+	{
+		if (X0 < OLED_DirtyStart[Page]) {OLED_DirtyStart[Page] = X0;}
+		if (X1 > OLED_DirtyEnd[Page]) {OLED_DirtyEnd[Page] = X1;}
+	}
+	OLED_EXIT_CRITICAL();
+}
+
+/**
+  * @brief  查询显存是否有尚未推送到屏幕的脏区
+  * @retval 1 有，0 无
+  */
+uint8_t OLED_IsDirty(void)
+{
+	uint8_t j;
+	for (j = 0; j < 8; j++)
+	{
+		if (OLED_DirtyStart[j] < OLED_DirtyEnd[j]) {return 1;}
+	}
+	return 0;
+}
+
+#if OLED_USE_HW_I2C
+
+/*页刷新帧：3条单命令（Co=1）设置光标，随后0x40控制字节接连续数据*/
+#define OLED_FRAME_HEADER	7
+static uint8_t OLED_TxBuf[OLED_FRAME_HEADER + 128];
+
+static volatile uint8_t OLED_FlushBusy = 0;		//DMA刷新进行中
+static volatile uint8_t OLED_FlushRescan = 0;	//刷新期间有新的刷新请求
+static volatile uint8_t OLED_FlushPage = 0;		//当前正在发送的页
+
+/*引脚、I2C2与DMA初始化*/
+void OLED_I2C_Init(void)
+{
+	GPIO_InitTypeDef GPIO_InitStructure;
+	I2C_InitTypeDef I2C_InitStructure;
+	DMA_InitTypeDef DMA_InitStructure;
+	NVIC_InitTypeDef NVIC_InitStructure;
+	
+	RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+	RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C2, ENABLE);
+	RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+	
+	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_OD;
+	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10 | GPIO_Pin_11;
+	GPIO_Init(GPIOB, &GPIO_InitStructure);
+	
+	I2C_DeInit(OLED_I2C);
+	I2C_InitStructure.I2C_Mode = I2C_Mode_I2C;
+	I2C_InitStructure.I2C_DutyCycle = I2C_DutyCycle_2;
+	I2C_InitStructure.I2C_OwnAddress1 = 0x00;
+	I2C_InitStructure.I2C_Ack = I2C_Ack_Disable;
+	I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+	I2C_InitStructure.I2C_ClockSpeed = OLED_I2C_SPEED;
+	I2C_Init(OLED_I2C, &I2C_InitStructure);
+	I2C_Cmd(OLED_I2C, ENABLE);
+	
+	DMA_DeInit(OLED_DMA_CHANNEL);
+	DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&OLED_I2C->DR;
+	DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)OLED_TxBuf;
+	DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+	DMA_InitStructure.DMA_BufferSize = 1;
+	DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+	DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+	DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+	DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+	DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+	DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+	DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+	DMA_Init(OLED_DMA_CHANNEL, &DMA_InitStructure);
+	DMA_ITConfig(OLED_DMA_CHANNEL, DMA_IT_TC, ENABLE);
+	
+	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIO_OLED;
+	NVIC_InitStructure.NVIC_IRQChannelSubPriority = IRQ_SUBPRIO_DEFAULT;
+	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+	NVIC_InitStructure.NVIC_IRQChannel = DMA1_Channel4_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = I2C2_EV_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+	NVIC_InitStructure.NVIC_IRQChannel = I2C2_ER_IRQn;
+	NVIC_Init(&NVIC_InitStructure);
+}
+
+/**
+  * @brief  等待上一帧的停止信号发送完毕（约一个SCL周期）
+  * @note   硬件检测到停止条件时同时清零CR1的STOP位和SR2的BUSY位；STOP清零前不得
+  *         再写CR1（RM0008），否则可能重复产生起止信号。只在线程中下一次开始传输前调用，
+  *         中断内不等待
+  */
+static void OLED_I2C_WaitStop(void)
+{
+	uint32_t Timeout = OLED_HW_TIMEOUT;
+	while (I2C_GetFlagStatus(OLED_I2C, I2C_FLAG_BUSY) == SET && --Timeout);
+}
+
+/**
+  * @brief  等待I2C事件，超时则发送停止信号
+  * @param  Event I2C事件，见I2C_CheckEvent
+  * @retval 1 成功，0 超时（从机无应答或总线异常）
+  */
+static uint8_t OLED_I2C_WaitEvent(uint32_t Event)
+{
+	uint32_t Timeout = OLED_HW_TIMEOUT;
+	while (I2C_CheckEvent(OLED_I2C, Event) != SUCCESS)
+	{
+		if (--Timeout == 0)
+		{
+			I2C_GenerateSTOP(OLED_I2C, ENABLE);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+  * @brief  阻塞方式发送一帧：从机地址 + 控制字节 + 数据
+  * @param  Control 控制字节，0x00命令/0x40数据
+  * @param  Bytes 数据序列
+  * @param  Count 数据个数
+  * @retval 无
+  */
+static void OLED_I2C_WriteFrame(uint8_t Control, const uint8_t *Bytes, uint16_t Count)
+{
+	uint16_t i;
+	
+	OLED_WaitIdle();		//等待后台刷新结束，避免与DMA帧交错
+	
+	I2C_GenerateSTART(OLED_I2C, ENABLE);
+	if (!OLED_I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) {return;}
+	I2C_Send7bitAddress(OLED_I2C, 0x78, I2C_Direction_Transmitter);
+	if (!OLED_I2C_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) {return;}
+	I2C_SendData(OLED_I2C, Control);
+	for (i = 0; i < Count; i++)
+	{
+		if (!OLED_I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTING)) {return;}
+		I2C_SendData(OLED_I2C, Bytes[i]);
+	}
+	if (!OLED_I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED)) {return;}
+	I2C_GenerateSTOP(OLED_I2C, ENABLE);
+}
+
+/**
+  * @brief  OLED连续写多条命令（阻塞）
+  * @param  Commands 命令序列
+  * @param  Count 命令个数
+  * @retval 无
+  */
+void OLED_WriteCommandList(const uint8_t *Commands, uint8_t Count)
+{
+	OLED_I2C_WriteFrame(0x00, Commands, Count);
+}
+
+/**
+  * @brief  OLED连续写多个数据（阻塞）
+  * @param  Data 数据序列
+  * @param  Count 数据个数
+  * @retval 无
+  */
+void OLED_WriteDataBurst(const uint8_t *Data, uint16_t Count)
+{
+	OLED_I2C_WriteFrame(0x40, Data, Count);
+}
+
+/**
+  * @brief  从Page开始查找下一个脏页，装帧并启动一次DMA传输（中断或临界区内调用）
+  * @param  Page 起始查找页
+  * @retval 1 已启动传输，0 没有脏页
+  */
+static uint8_t OLED_StartPage(uint8_t Page)
+{
+	uint8_t i, X0, X1;
+	
+	for (; Page < 8; Page++)
+	{
+		if (OLED_DirtyStart[Page] < OLED_DirtyEnd[Page]) {break;}
+	}
+	if (Page >= 8) {return 0;}
+	
+	X0 = OLED_DirtyStart[Page];
+	X1 = OLED_DirtyEnd[Page];
+	OLED_DirtyStart[Page] = 0;
+	OLED_DirtyEnd[Page] = 0;
+	
+	OLED_TxBuf[0] = 0x80;	OLED_TxBuf[1] = 0xB0 | Page;				//设置Y位置
+	OLED_TxBuf[2] = 0x80;	OLED_TxBuf[3] = 0x10 | ((X0 & 0xF0) >> 4);	//设置X位置高4位
+	OLED_TxBuf[4] = 0x80;	OLED_TxBuf[5] = 0x00 | (X0 & 0x0F);			//设置X位置低4位
+	OLED_TxBuf[6] = 0x40;												//其后均为数据
+	for (i = X0; i < X1; i++)
+	{
+		OLED_TxBuf[OLED_FRAME_HEADER + i - X0] = OLED_DisplayBuf[Page][i];
+	}
+	OLED_FlushPage = Page;
+	TRACE_MARK(TRACE_OLED_FLUSH, Page);		//硬件I2C下只记录每页DMA启动
+	
+	DMA_Cmd(OLED_DMA_CHANNEL, DISABLE);
+	OLED_DMA_CHANNEL->CMAR = (uint32_t)OLED_TxBuf;
+	OLED_DMA_CHANNEL->CNDTR = OLED_FRAME_HEADER + X1 - X0;
+	I2C_DMACmd(OLED_I2C, ENABLE);
+	I2C_ITConfig(OLED_I2C, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+	I2C_GenerateSTART(OLED_I2C, ENABLE);		//后续由I2C2_EV中断发送地址并开启DMA；上一页未停止时为重复起始
+	return 1;
+}
+
+/**
+  * @brief  当前页发送完毕（BTF），以重复起始接续下一脏页，没有则停止并结束刷新（中断内调用）
+  * @note   页与页之间不发停止信号，中断内无需等待STOP位清零；最后的停止由下一次
+  *         开始传输前的OLED_I2C_WaitStop收尾
+  */
+static void OLED_NextPage(void)
+{
+	if (OLED_StartPage(OLED_FlushPage + 1)) {return;}
+	if (OLED_FlushRescan)
+	{
+		OLED_FlushRescan = 0;
+		if (OLED_StartPage(0)) {return;}
+	}
+	I2C_GenerateSTOP(OLED_I2C, ENABLE);
+	I2C_ITConfig(OLED_I2C, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+	OLED_FlushBusy = 0;
+}
+
+/**
+  * @brief  启动后台刷新，立即返回；各页由DMA发送，完成后在中断中接续
+  * @param  无
+  * @retval 无
+  */
+void OLED_Flush(void)
+{
+	if (!OLED_FlushBusy) {OLED_I2C_WaitStop();}	//空闲时总线上至多剩一个未完成的停止信号
+	
+	OLED_ENTER_CRITICAL();
+	if (OLED_FlushBusy)
+	{
+		OLED_FlushRescan = 1;		//当前轮结束后再扫描一遍
+	}
+	else if (OLED_StartPage(0))
+	{
+		OLED_FlushBusy = 1;
+	}
+	OLED_EXIT_CRITICAL();
+}
+
+/**
+  * @brief  分片刷新：硬件I2C下发送由DMA在后台完成，这里只负责启动
+  * @param  MaxBytes 未使用
+  * @retval 0 无需调用者继续分片
+  */
+uint8_t OLED_FlushStep(uint8_t MaxBytes)
+{
+	(void)MaxBytes;
+	OLED_Flush();
+	return 0;
+}
+
+/**
+  * @brief  查询后台刷新是否进行中
+  * @retval 1 进行中，0 空闲
+  */
+uint8_t OLED_IsBusy(void)
+{
+	return OLED_FlushBusy;
+}
+
+/**
+  * @brief  等待后台刷新结束
+  */
+void OLED_WaitIdle(void)
+{
+	while (OLED_FlushBusy);
+	OLED_I2C_WaitStop();
+}
+
+/**
+  * @brief  I2C2事件中断：起始位后发地址，地址应答后交给DMA，末字节发完后接续下一页或停止
+  */
+void I2C2_EV_IRQHandler(void)
+{
+	ISR_ENTER(ISR_OLED, ISR_LATENCY_NONE);
+	uint16_t SR1 = OLED_I2C->SR1;
+	
+	if (SR1 & I2C_SR1_SB)
+	{
+		I2C_Send7bitAddress(OLED_I2C, 0x78, I2C_Direction_Transmitter);
+	}
+	else if (SR1 & I2C_SR1_ADDR)
+	{
+		(void)OLED_I2C->SR2;						//读SR1后读SR2清除ADDR
+		I2C_ITConfig(OLED_I2C, I2C_IT_EVT, DISABLE);	//数据阶段不再响应事件中断
+		DMA_Cmd(OLED_DMA_CHANNEL, ENABLE);
+	}
+	else if (SR1 & I2C_SR1_BTF)
+	{
+		OLED_NextPage();
+	}
+	ISR_EXIT(ISR_OLED);
+}
+
+/**
+  * @brief  I2C2错误中断：放弃当前页并重新标脏，结束本轮刷新
+  */
+void I2C2_ER_IRQHandler(void)
+{
+	ISR_ENTER(ISR_OLED, ISR_LATENCY_NONE);
+	OLED_I2C->SR1 &= ~(I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR | I2C_SR1_OVR);
+	DMA_Cmd(OLED_DMA_CHANNEL, DISABLE);
+	I2C_DMACmd(OLED_I2C, DISABLE);
+	I2C_GenerateSTOP(OLED_I2C, ENABLE);
+	OLED_MarkDirty(OLED_FlushPage, 0, 128);
+	I2C_ITConfig(OLED_I2C, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+	OLED_FlushBusy = 0;
+	ISR_EXIT(ISR_OLED);
+}
+
+/**
+  * @brief  DMA1通道4传输完成中断：数据已全部写入DR，等待BTF后产生停止信号
+  */
+void DMA1_Channel4_IRQHandler(void)
+{
+	ISR_ENTER(ISR_OLED, ISR_LATENCY_NONE);
+	if (DMA_GetITStatus(OLED_DMA_IT_TC) != RESET)
+	{
+		DMA_ClearITPendingBit(OLED_DMA_IT_GL);
+		DMA_Cmd(OLED_DMA_CHANNEL, DISABLE);
+		I2C_DMACmd(OLED_I2C, DISABLE);
+		I2C_ITConfig(OLED_I2C, I2C_IT_EVT, ENABLE);	//由BTF事件收尾
+	}
+	ISR_EXIT(ISR_OLED);
+}
+
+#else
 
 /*引脚初始化*/
 void OLED_I2C_Init(void)
@@ -13,13 +437,13 @@ void OLED_I2C_Init(void)
 	GPIO_InitTypeDef GPIO_InitStructure;
  	GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
 	GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_1;
+	GPIO_InitStructure.GPIO_Pin = OLED_SCL_PIN;
  	GPIO_Init(GPIOB, &GPIO_InitStructure);
-	GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;
+	GPIO_InitStructure.GPIO_Pin = OLED_SDA_PIN;
  	GPIO_Init(GPIOB, &GPIO_InitStructure);
 	
-	OLED_W_SCL(1);
-	OLED_W_SDA(1);
+	OLED_SCL_H();
+	OLED_SDA_H();
 }
 
 /**
@@ -29,10 +453,12 @@ void OLED_I2C_Init(void)
   */
 void OLED_I2C_Start(void)
 {
-	OLED_W_SDA(1);
-	OLED_W_SCL(1);
-	OLED_W_SDA(0);
-	OLED_W_SCL(0);
+	OLED_SDA_H();
+	OLED_SCL_H();
+	OLED_I2C_DELAY(OLED_I2C_HIGH_LOOPS);
+	OLED_SDA_L();
+	OLED_I2C_DELAY(OLED_I2C_HIGH_LOOPS);
+	OLED_SCL_L();
 }
 
 /**
@@ -42,43 +468,153 @@ void OLED_I2C_Start(void)
   */
 void OLED_I2C_Stop(void)
 {
-	OLED_W_SDA(0);
-	OLED_W_SCL(1);
-	OLED_W_SDA(1);
+	OLED_SDA_L();
+	OLED_I2C_DELAY(OLED_I2C_LOW_LOOPS);
+	OLED_SCL_H();
+	OLED_I2C_DELAY(OLED_I2C_HIGH_LOOPS);
+	OLED_SDA_H();
 }
 
+/*发送一位：SCL低电平期间准备SDA，再打一个时钟*/
+#define OLED_I2C_SEND_BIT(Byte, Mask)				\
+	do {											\
+		if ((Byte) & (Mask)) {OLED_SDA_H();}		\
+		else {OLED_SDA_L();}						\
+		OLED_I2C_DELAY(OLED_I2C_LOW_LOOPS);			\
+		OLED_SCL_H();								\
+		OLED_I2C_DELAY(OLED_I2C_HIGH_LOOPS);		\
+		OLED_SCL_L();								\
+	} while (0)
+
 /**
-  * @brief  I2C发送一个字节
+  * @brief  I2C发送一个字节（8位展开）
   * @param  Byte 要发送的一个字节
   * @retval 无
   */
 void OLED_I2C_SendByte(uint8_t Byte)
+{
+	OLED_I2C_SEND_BIT(Byte, 0x80);
+	OLED_I2C_SEND_BIT(Byte, 0x40);
+	OLED_I2C_SEND_BIT(Byte, 0x20);
+	OLED_I2C_SEND_BIT(Byte, 0x10);
+	OLED_I2C_SEND_BIT(Byte, 0x08);
+	OLED_I2C_SEND_BIT(Byte, 0x04);
+	OLED_I2C_SEND_BIT(Byte, 0x02);
+	OLED_I2C_SEND_BIT(Byte, 0x01);
+	OLED_SDA_H();							//释放SDA
+	OLED_I2C_DELAY(OLED_I2C_LOW_LOOPS);
+	OLED_SCL_H();							//额外的一个时钟，不处理应答信号
+	OLED_I2C_DELAY(OLED_I2C_HIGH_LOOPS);
+	OLED_SCL_L();
+}
+
+/**
+  * @brief  OLED连续写多条命令（一次起止信号，控制字节Co=0）
+  * @param  Commands 命令序列
+  * @param  Count 命令个数
+  * @retval 无
+  */
+void OLED_WriteCommandList(const uint8_t *Commands, uint8_t Count)
 {
 	uint8_t i;
-	for (i = 0; i < 8; i++)
+	OLED_I2C_Start();
+	OLED_I2C_SendByte(0x78);		//从机地址
+	OLED_I2C_SendByte(0x00);		//写命令，后续字节均为命令
+	for (i = 0; i < Count; i++)
 	{
-		OLED_W_SDA(!!(Byte & (0x80 >> i)));
-		OLED_W_SCL(1);
-		OLED_W_SCL(0);
+		OLED_I2C_SendByte(Commands[i]);
 	}
-	OLED_W_SCL(1);	//额外的一个时钟，不处理应答信号
-	OLED_W_SCL(0);
+	OLED_I2C_Stop();
 }
 
 /**
-  * @brief  OLED写命令
-  * @param  Command 要写入的命令
+  * @brief  OLED连续写多个数据（一次起止信号，写入GDDRAM后列地址自动递增）
+  * @param  Data 数据序列
+  * @param  Count 数据个数
   * @retval 无
   */
-void OLED_WriteCommand(uint8_t Command)
+void OLED_WriteDataBurst(const uint8_t *Data, uint16_t Count)
 {
+	uint16_t i;
 	OLED_I2C_Start();
 	OLED_I2C_SendByte(0x78);		//从机地址
-	OLED_I2C_SendByte(0x00);		//写命令
-	OLED_I2C_SendByte(Command); 
+	OLED_I2C_SendByte(0x40);		//写数据，后续字节均为数据
+	for (i = 0; i < Count; i++)
+	{
+		OLED_I2C_SendByte(Data[i]);
+	}
 	OLED_I2C_Stop();
 }
 
+/**
+  * @brief  分片刷新：发送第一个脏页中最多MaxBytes字节，用于在空闲时间内逐步推送显存
+  * @param  MaxBytes 本次最多发送的数据字节数，范围：1~128
+  * @retval 1 仍有脏区待发送，0 显存已全部同步
+  */
+uint8_t OLED_FlushStep(uint8_t MaxBytes)
+{
+	uint8_t j, X0, Count;
+	for (j = 0; j < 8; j++)
+	{
+		if (OLED_DirtyStart[j] < OLED_DirtyEnd[j]) {break;}
+	}
+	if (j >= 8) {return 0;}
+	
+	X0 = OLED_DirtyStart[j];
+	Count = OLED_DirtyEnd[j] - X0;
+	if (Count > MaxBytes) {Count = MaxBytes;}
+	
+	TRACE_BEGIN(TRACE_OLED_FLUSH, j);
+	OLED_SetCursor(j, X0);
+	OLED_WriteDataBurst(&OLED_DisplayBuf[j][X0], Count);
+	TRACE_END(TRACE_OLED_FLUSH, Count);
+	OLED_DirtyStart[j] = X0 + Count;		//剩余部分留给下一片
+	
+	for (; j < 8; j++)
+	{
+		if (OLED_DirtyStart[j] < OLED_DirtyEnd[j]) {return 1;}
+	}
+	return 0;
+}
+
+/**
+  * @brief  将显存中的脏区刷新到屏幕，每页只发送一次连续数据
+  * @param  无
+  * @retval 无
+  */
+void OLED_Flush(void)
+{
+	while (OLED_FlushStep(128));
+}
+
+/**
+  * @brief  查询后台刷新是否进行中（软件I2C为阻塞刷新，恒为空闲）
+  * @retval 0
+  */
+uint8_t OLED_IsBusy(void)
+{
+	return 0;
+}
+
+/**
+  * @brief  等待后台刷新结束（软件I2C无需等待）
+  */
+void OLED_WaitIdle(void)
+{
+}
+
+#endif
+
+/**
+  * @brief  OLED写命令
+  * @param  Command 要写入的命令
+  * @retval 无
+  */
+void OLED_WriteCommand(uint8_t Command)
+{
+	OLED_WriteCommandList(&Command, 1);
+}
+
 /**
   * @brief  OLED写数据
   * @param  Data 要写入的数据
@@ -86,11 +622,7 @@ void OLED_WriteCommand(uint8_t Command)
   */
 void OLED_WriteData(uint8_t Data)
 {
-	OLED_I2C_Start();
-	OLED_I2C_SendByte(0x78);		//从机地址
-	OLED_I2C_SendByte(0x40);		//写数据
-	OLED_I2C_SendByte(Data);
-	OLED_I2C_Stop();
+	OLED_WriteDataBurst(&Data, 1);
 }
 
 /**
@@ -101,13 +633,15 @@ void OLED_WriteData(uint8_t Data)
   */
 void OLED_SetCursor(uint8_t Y, uint8_t X)
 {
-	OLED_WriteCommand(0xB0 | Y);					//设置Y位置
-	OLED_WriteCommand(0x10 | ((X & 0xF0) >> 4));	//设置X位置高4位
-	OLED_WriteCommand(0x00 | (X & 0x0F));			//设置X位置低4位
+	uint8_t Commands[3];
+	Commands[0] = 0xB0 | Y;					//设置Y位置
+	Commands[1] = 0x10 | ((X & 0xF0) >> 4);	//设置X位置高4位
+	Commands[2] = 0x00 | (X & 0x0F);			//设置X位置低4位
+	OLED_WriteCommandList(Commands, 3);
 }
 
 /**
-  * @brief  OLED清屏
+  * @brief  OLED清屏（仅清显存，调用OLED_Flush后生效）
   * @param  无
   * @retval 无
   */
@@ -116,16 +650,37 @@ void OLED_Clear(void)
 	uint8_t i, j;
 	for (j = 0; j < 8; j++)
 	{
-		OLED_SetCursor(j, 0);
 		for(i = 0; i < 128; i++)
 		{
-			OLED_WriteData(0x00);
+			OLED_DisplayBuf[j][i] = 0x00;
+		}
+		OLED_MarkDirty(j, 0, 128);
+	}
+}
+
+/**
+  * @brief  OLED写入一整列像素（写入显存，调用OLED_Flush后生效）
+  * @param  X 列位置，范围：0~127
+  * @param  Column 8个页的列数据，Column[0]为最上方页，每字节低位在上
+  * @retval 无
+  * @note   每页只标记1字节脏区，刷新时一列共8字节
+  */
+void OLED_DrawColumn(uint8_t X, const uint8_t *Column)
+{
+	uint8_t j;
+	if (X > 127) {return;}
+	for (j = 0; j < 8; j++)
+	{
+		if (OLED_DisplayBuf[j][X] != Column[j])
+		{
+			OLED_DisplayBuf[j][X] = Column[j];
+			OLED_MarkDirty(j, X, X + 1);
 		}
 	}
 }
 
 /**
-  * @brief  OLED显示一个字符
+  * @brief  OLED显示一个字符（写入显存，调用OLED_Flush后生效）
   * @param  Line 行位置，范围：1~4
   * @param  Column 列位置，范围：1~16
   * @param  Char 要显示的一个字符，范围：ASCII可见字符
@@ -133,17 +688,21 @@ void OLED_Clear(void)
   */
 void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char)
 {      	
-	uint8_t i;
-	OLED_SetCursor((Line - 1) * 2, (Column - 1) * 8);		//设置光标位置在上半部分
-	for (i = 0; i < 8; i++)
-	{
-		OLED_WriteData(OLED_F8x16[Char - ' '][i]);			//显示上半部分内容
-	}
-	OLED_SetCursor((Line - 1) * 2 + 1, (Column - 1) * 8);	//设置光标位置在下半部分
+	uint8_t i, Page, X;
+	if (Line < 1 || Line > 4 || Column < 1 || Column > 16) {return;}
+	if (Char < ' ' || Char > '~') {Char = ' ';}
+	
+	PROF_BEGIN(PROF_OLED_CHAR);
+	Page = (Line - 1) * 2;
+	X = (Column - 1) * 8;
 	for (i = 0; i < 8; i++)
 	{
-		OLED_WriteData(OLED_F8x16[Char - ' '][i + 8]);		//显示下半部分内容
+		OLED_DisplayBuf[Page][X + i] = OLED_F8x16[Char - ' '][i];			//上半部分内容
+		OLED_DisplayBuf[Page + 1][X + i] = OLED_F8x16[Char - ' '][i + 8];	//下半部分内容
 	}
+	OLED_MarkDirty(Page, X, X + 8);
+	OLED_MarkDirty(Page + 1, X, X + 8);
+	PROF_END(PROF_OLED_CHAR);
 }
 
 /**
@@ -162,6 +721,46 @@ void OLED_ShowString(uint8_t Line, uint8_t Column, char *String)
 	}
 }
 
+/**
+  * @brief  OLED显示一个6x8小字符（写入显存，调用OLED_Flush后生效）
+  * @param  Line 行位置，范围：1~8
+  * @param  Column 列位置，范围：1~21
+  * @param  Char 要显示的一个字符，未收录在字模子集中的字符显示为空格
+  * @retval 无
+  */
+void OLED_ShowChar6x8(uint8_t Line, uint8_t Column, char Char)
+{
+	uint8_t i, Page, X, Glyph;
+	if (Line < 1 || Line > 8 || Column < 1 || Column > 21) {return;}
+	
+	Glyph = OLED_F6X8_NONE;
+	if (Char >= ' ' && Char <= '~') {Glyph = OLED_F6x8_Index[Char - ' '];}
+	
+	Page = Line - 1;
+	X = (Column - 1) * 6;
+	for (i = 0; i < 6; i++)
+	{
+		OLED_DisplayBuf[Page][X + i] = (Glyph == OLED_F6X8_NONE) ? 0x00 : OLED_F6x8[Glyph][i];
+	}
+	OLED_MarkDirty(Page, X, X + 6);
+}
+
+/**
+  * @brief  OLED显示6x8小字符串
+  * @param  Line 行位置，范围：1~8
+  * @param  Column 起始列位置，范围：1~21
+  * @param  String 要显示的字符串
+  * @retval 无
+  */
+void OLED_ShowString6x8(uint8_t Line, uint8_t Column, char *String)
+{
+	uint8_t i;
+	for (i = 0; String[i] != '\0'; i++)
+	{
+		OLED_ShowChar6x8(Line, Column + i, String[i]);
+	}
+}
+
 /**
   * @brief  OLED次方函数
   * @retval 返回值等于X的Y次方
@@ -279,43 +878,8 @@ void OLED_Init(void)
 	
 	OLED_I2C_Init();			//端口初始化
 	
-	OLED_WriteCommand(0xAE);	//关闭显示
-	
-	OLED_WriteCommand(0xD5);	//设置显示时钟分频比/振荡器频率
-	OLED_WriteCommand(0x80);
-	
-	OLED_WriteCommand(0xA8);	//设置多路复用率
-	OLED_WriteCommand(0x3F);
-	
-	OLED_WriteCommand(0xD3);	//设置显示偏移
-	OLED_WriteCommand(0x00);
-	
-	OLED_WriteCommand(0x40);	//设置显示开始行
-	
-	OLED_WriteCommand(0xA1);	//设置左右方向，0xA1正常 0xA0左右反置
-	
-	OLED_WriteCommand(0xC8);	//设置上下方向，0xC8正常 0xC0上下反置
-
-	OLED_WriteCommand(0xDA);	//设置COM引脚硬件配置
-	OLED_WriteCommand(0x12);
-	
-	OLED_WriteCommand(0x81);	//设置对比度控制
-	OLED_WriteCommand(0xCF);
-
-	OLED_WriteCommand(0xD9);	//设置预充电周期
-	OLED_WriteCommand(0xF1);
-
-	OLED_WriteCommand(0xDB);	//设置VCOMH取消选择级别
-	OLED_WriteCommand(0x30);
-
-	OLED_WriteCommand(0xA4);	//设置整个显示打开/关闭
-
-	OLED_WriteCommand(0xA6);	//设置正常/倒转显示
-
-	OLED_WriteCommand(0x8D);	//设置充电泵
-	OLED_WriteCommand(0x14);
-
-	OLED_WriteCommand(0xAF);	//开启显示
+	OLED_WriteCommandList(OLED_InitCommands, sizeof(OLED_InitCommands));	//一次传输完成全部初始化命令
 		
 	OLED_Clear();				//OLED清屏
+	OLED_Flush();
 }
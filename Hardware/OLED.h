@@ -3,11 +3,31 @@
 
 #include "stm32f10x.h"
 
+/*OLED总线后端选择
+  0：软件I2C，PB1=SCL，PB0=SDA，OLED_Flush阻塞至发送完毕
+  1：硬件I2C2+DMA1通道4，PB10=SCL，PB11=SDA，400kHz，OLED_Flush立即返回*/
+#ifndef OLED_USE_HW_I2C
+#define OLED_USE_HW_I2C		0
+#endif
+
 void OLED_I2C_Init(void);
+void OLED_WriteCommand(uint8_t Command);
+void OLED_WriteData(uint8_t Data);
+void OLED_WriteCommandList(const uint8_t *Commands, uint8_t Count);
+void OLED_WriteDataBurst(const uint8_t *Data, uint16_t Count);
+void OLED_SetCursor(uint8_t Y, uint8_t X);
 void OLED_Init(void);
 void OLED_Clear(void);
+void OLED_DrawColumn(uint8_t X, const uint8_t *Column);
+void OLED_Flush(void);
+uint8_t OLED_FlushStep(uint8_t MaxBytes);
+uint8_t OLED_IsBusy(void);
+uint8_t OLED_IsDirty(void);
+void OLED_WaitIdle(void);
 void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char);
 void OLED_ShowString(uint8_t Line, uint8_t Column, char *String);
+void OLED_ShowChar6x8(uint8_t Line, uint8_t Column, char Char);
+void OLED_ShowString6x8(uint8_t Line, uint8_t Column, char *String);
 void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
 void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Length);
 void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
@@ -0,0 +1,95 @@
+#ifndef __OLED_FONT6X8_H
+#define __OLED_FONT6X8_H
+
+/*OLED字模库，宽6像素，高8像素
+  由 Tools/gen_font6x8.py 生成，只包含固件字符串用到的字形，请勿手工修改*/
+#define OLED_F6X8_COUNT		71
+#define OLED_F6X8_NONE		0xFF
+
+const uint8_t OLED_F6x8[][6]=
+{
+	0x00,0x00,0x00,0x00,0x00,0x00,//  0
+	0x00,0x23,0x13,0x08,0x64,0x62,//% 1
+	0x00,0x08,0x08,0x3E,0x08,0x08,//+ 2
+	0x00,0x08,0x08,0x08,0x08,0x08,//- 3
+	0x00,0x00,0x60,0x60,0x00,0x00,//. 4
+	0x00,0x20,0x10,0x08,0x04,0x02,/// 5
+	0x00,0x3E,0x51,0x49,0x45,0x3E,//0 6
+	0x00,0x00,0x42,0x7F,0x40,0x00,//1 7
+	0x00,0x42,0x61,0x51,0x49,0x46,//2 8
+	0x00,0x21,0x41,0x45,0x4B,0x31,//3 9
+	0x00,0x18,0x14,0x12,0x7F,0x10,//4 10
+	0x00,0x27,0x45,0x45,0x45,0x39,//5 11
+	0x00,0x3C,0x4A,0x49,0x49,0x30,//6 12
+	0x00,0x01,0x71,0x09,0x05,0x03,//7 13
+	0x00,0x36,0x49,0x49,0x49,0x36,//8 14
+	0x00,0x06,0x49,0x49,0x29,0x1E,//9 15
+	0x00,0x00,0x36,0x36,0x00,0x00,//: 16
+	0x00,0x14,0x14,0x14,0x14,0x14,//= 17
+	0x00,0x00,0x41,0x22,0x14,0x08,//> 18
+	0x00,0x02,0x01,0x51,0x09,0x06,//? 19
+	0x00,0x7E,0x11,0x11,0x11,0x7E,//A 20
+	0x00,0x7F,0x49,0x49,0x49,0x36,//B 21
+	0x00,0x3E,0x41,0x41,0x41,0x22,//C 22
+	0x00,0x7F,0x41,0x41,0x22,0x1C,//D 23
+	0x00,0x7F,0x49,0x49,0x49,0x41,//E 24
+	0x00,0x7F,0x09,0x09,0x09,0x01,//F 25
+	0x00,0x3E,0x41,0x49,0x49,0x7A,//G 26
+	0x00,0x7F,0x08,0x08,0x08,0x7F,//H 27
+	0x00,0x00,0x41,0x7F,0x41,0x00,//I 28
+	0x00,0x20,0x40,0x41,0x3F,0x01,//J 29
+	0x00,0x7F,0x08,0x14,0x22,0x41,//K 30
+	0x00,0x7F,0x40,0x40,0x40,0x40,//L 31
+	0x00,0x7F,0x02,0x0C,0x02,0x7F,//M 32
+	0x00,0x7F,0x04,0x08,0x10,0x7F,//N 33
+	0x00,0x3E,0x41,0x41,0x41,0x3E,//O 34
+	0x00,0x7F,0x09,0x09,0x09,0x06,//P 35
+	0x00,0x3E,0x41,0x51,0x21,0x5E,//Q 36
+	0x00,0x7F,0x09,0x19,0x29,0x46,//R 37
+	0x00,0x46,0x49,0x49,0x49,0x31,//S 38
+	0x00,0x01,0x01,0x7F,0x01,0x01,//T 39
+	0x00,0x3F,0x40,0x40,0x40,0x3F,//U 40
+	0x00,0x1F,0x20,0x40,0x20,0x1F,//V 41
+	0x00,0x3F,0x40,0x38,0x40,0x3F,//W 42
+	0x00,0x63,0x14,0x08,0x14,0x63,//X 43
+	0x00,0x40,0x40,0x40,0x40,0x40,//_ 44
+	0x00,0x20,0x54,0x54,0x54,0x78,//a 45
+	0x00,0x7F,0x48,0x44,0x44,0x38,//b 46
+	0x00,0x38,0x44,0x44,0x44,0x20,//c 47
+	0x00,0x38,0x44,0x44,0x48,0x7F,//d 48
+	0x00,0x38,0x54,0x54,0x54,0x18,//e 49
+	0x00,0x08,0x7E,0x09,0x01,0x02,//f 50
+	0x00,0x0C,0x52,0x52,0x52,0x3E,//g 51
+	0x00,0x7F,0x08,0x04,0x04,0x78,//h 52
+	0x00,0x00,0x44,0x7D,0x40,0x00,//i 53
+	0x00,0x7F,0x10,0x28,0x44,0x00,//k 54
+	0x00,0x00,0x41,0x7F,0x40,0x00,//l 55
+	0x00,0x7C,0x04,0x18,0x04,0x78,//m 56
+	0x00,0x7C,0x08,0x04,0x04,0x78,//n 57
+	0x00,0x38,0x44,0x44,0x44,0x38,//o 58
+	0x00,0x7C,0x14,0x14,0x14,0x08,//p 59
+	0x00,0x08,0x14,0x14,0x18,0x7C,//q 60
+	0x00,0x7C,0x08,0x04,0x04,0x08,//r 61
+	0x00,0x48,0x54,0x54,0x54,0x20,//s 62
+	0x00,0x04,0x3F,0x44,0x40,0x20,//t 63
+	0x00,0x3C,0x40,0x40,0x20,0x7C,//u 64
+	0x00,0x1C,0x20,0x40,0x20,0x1C,//v 65
+	0x00,0x3C,0x40,0x30,0x40,0x3C,//w 66
+	0x00,0x44,0x28,0x10,0x28,0x44,//x 67
+	0x00,0x0C,0x50,0x50,0x50,0x3C,//y 68
+	0x00,0x44,0x64,0x54,0x4C,0x44,//z 69
+	0x00,0x08,0x04,0x08,0x10,0x08,//~ 70
+};
+
+/*字符到字形序号的映射，下标为 字符-' '，0xFF(OLED_F6X8_NONE) 表示未收录*/
+const uint8_t OLED_F6x8_Index[95]=
+{
+	0,0xFF,0xFF,0xFF,0xFF,1,0xFF,0xFF,0xFF,0xFF,0xFF,2,0xFF,3,4,5,
+	6,7,8,9,10,11,12,13,14,15,16,0xFF,0xFF,17,18,19,
+	0xFF,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,
+	35,36,37,38,39,40,41,42,43,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,44,
+	0xFF,45,46,47,48,49,50,51,52,53,0xFF,54,55,56,57,58,
+	59,60,61,62,63,64,65,66,67,68,69,0xFF,0xFF,0xFF,70,
+};
+
+#endif
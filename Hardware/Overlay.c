@@ -0,0 +1,101 @@
+/*==============================================================================
+  文件：Overlay.c
+  功能：非阻塞的定时提示
+        提示显示期间控制循环照常运行，各界面暂停绘制；
+        队列中的提示依次显示，全部结束后调用恢复函数重画原界面
+==============================================================================*/
+#include "stm32f10x.h"
+#include "Timebase.h"
+#include "OLED.h"
+#include "Overlay.h"
+
+typedef struct {
+    char    *text;          // 提示文字（字符串常量）
+    uint8_t  line;
+    uint8_t  column;
+    uint16_t duration;      // 显示时长 ms
+} Overlay_t;
+
+static Overlay_t overlay_queue[OVERLAY_QUEUE_SIZE];
+static uint8_t   overlay_head = 0;
+static uint8_t   overlay_count = 0;
+static uint8_t   overlay_active = 0;
+static uint32_t  overlay_start = 0;
+static void    (*overlay_restore)(void) = 0;
+
+/**
+  * @brief  显示队首提示并开始计时
+  */
+static void Overlay_Start(void)
+{
+    Overlay_t *o = &overlay_queue[overlay_head];
+
+    OLED_Clear();
+    OLED_ShowString(o->line, o->column, o->text);
+    overlay_start = Time_Ms();
+    overlay_active = 1;
+}
+
+/**
+  * @brief  提示模块初始化
+  * @param  restore: 提示结束后重画原界面的函数
+  */
+void Overlay_Init(void (*restore)(void))
+{
+    overlay_restore = restore;
+    overlay_head = 0;
+    overlay_count = 0;
+    overlay_active = 0;
+}
+
+/**
+  * @brief  显示一条提示，立即返回
+  * @param  line/column: 显示位置（8x16 字体）
+  * @param  text: 提示文字，须为常量或静态字符串
+  * @param  duration_ms: 显示时长
+  * @note   已有提示在显示时排队；队列满时丢弃新提示
+  */
+void Overlay_Show(uint8_t line, uint8_t column, char *text, uint16_t duration_ms)
+{
+    if (overlay_count >= OVERLAY_QUEUE_SIZE) return;
+
+    Overlay_t *o = &overlay_queue[(overlay_head + overlay_count) % OVERLAY_QUEUE_SIZE];
+    o->text = text;
+    o->line = line;
+    o->column = column;
+    o->duration = duration_ms;
+    overlay_count++;
+
+    if (!overlay_active) {
+        Overlay_Start();
+    }
+}
+
+/**
+  * @brief  主循环中调用：到时切换到下一条提示，全部结束后恢复原界面
+  */
+void Overlay_Update(void)
+{
+    if (!overlay_active) return;
+    if (Time_Ms() - overlay_start < overlay_queue[overlay_head].duration) return;
+
+    overlay_head = (overlay_head + 1) % OVERLAY_QUEUE_SIZE;
+    overlay_count--;
+
+    if (overlay_count > 0) {
+        Overlay_Start();
+        return;
+    }
+    overlay_active = 0;
+    if (overlay_restore) {
+        overlay_restore();
+    }
+}
+
+/**
+  * @brief  是否有提示正在显示（期间各界面不应绘制）
+  */
+uint8_t Overlay_IsActive(void)
+{
+    return overlay_active;
+}
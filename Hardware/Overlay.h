@@ -0,0 +1,17 @@
+/*==============================================================================
+  文件：Overlay.h
+  功能：非阻塞的定时提示（模式切换、保存结果等），到时后恢复原界面
+==============================================================================*/
+#ifndef __OVERLAY_H
+#define __OVERLAY_H
+
+#include <stdint.h>
+
+#define OVERLAY_QUEUE_SIZE  4   // 排队提示数，依次显示
+
+void Overlay_Init(void (*restore)(void));
+void Overlay_Show(uint8_t line, uint8_t column, char *text, uint16_t duration_ms);
+void Overlay_Update(void);
+uint8_t Overlay_IsActive(void);
+
+#endif // __OVERLAY_H
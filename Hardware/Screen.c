@@ -0,0 +1,94 @@
+/*==============================================================================
+  文件：Screen.c
+  功能：表格描述的 OLED 页面渲染
+        维护一份 4×16 字符影子缓冲，只把与屏幕现有内容不同的字符写入显存
+==============================================================================*/
+#include "stm32f10x.h"
+#include "OLED.h"
+#include "Screen.h"
+
+// 屏幕上每个字符位置当前显示的内容，0 表示未知（需要重绘）
+static char screen_text[SCREEN_LINES][SCREEN_COLUMNS];
+
+/**
+  * @brief  清屏并同步影子缓冲（空格字模全为 0，与清屏后的屏幕一致）
+  */
+void Screen_Clear(void)
+{
+    OLED_Clear();
+    for (uint8_t i = 0; i < SCREEN_LINES; i++) {
+        for (uint8_t j = 0; j < SCREEN_COLUMNS; j++) {
+            screen_text[i][j] = ' ';
+        }
+    }
+}
+
+/**
+  * @brief  屏幕内容被其他代码改写后调用，下一次渲染全部重画
+  */
+void Screen_Invalidate(void)
+{
+    for (uint8_t i = 0; i < SCREEN_LINES; i++) {
+        for (uint8_t j = 0; j < SCREEN_COLUMNS; j++) {
+            screen_text[i][j] = 0;
+        }
+    }
+}
+
+/**
+  * @brief  在指定位置写入文本，宽度不足补空格，只重画有变化的字符
+  * @param  line: 行 1~4
+  * @param  column: 起始列 1~16
+  * @param  text: 文本
+  * @param  width: 占用宽度（0 表示按文本长度）
+  */
+void Screen_PutText(uint8_t line, uint8_t column, const char *text, uint8_t width)
+{
+    if (line == 0 || line > SCREEN_LINES || column == 0 || column > SCREEN_COLUMNS) return;
+
+    char *row = screen_text[line - 1];
+    uint8_t i = 0;
+    uint8_t ended = 0;
+    for (uint8_t col = column - 1; col < SCREEN_COLUMNS; col++, i++) {
+        char c;
+        if (!ended && text[i] != '\0') {
+            c = text[i];
+        } else {
+            ended = 1;
+            if (i >= width) break;
+            c = ' ';
+        }
+        if (row[col] != c) {
+            row[col] = c;
+            OLED_ShowChar(line, col + 1, c);
+        }
+    }
+}
+
+/**
+  * @brief  按字段表渲染一页
+  * @param  fields: 字段表
+  * @param  count: 字段数
+  */
+void Screen_Render(const ScreenField_t *fields, uint8_t count)
+{
+    char buf[SCREEN_COLUMNS + 1];
+
+    for (uint8_t i = 0; i < count; i++) {
+        const ScreenField_t *f = &fields[i];
+        const char *text;
+
+        if (f->format != 0) {
+            f->format(buf, f->source);
+            buf[SCREEN_COLUMNS] = '\0';
+            text = buf;
+        } else {
+            text = (const char *)f->source;
+        }
+        Screen_PutText(f->line, f->column, text, f->width);
+
+        if (f->unit != 0) {
+            Screen_PutText(f->line, f->column + f->width, f->unit, 0);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/*==============================================================================
+  文件：Screen.h
+  功能：表格描述的 OLED 页面（字段位置/宽度/格式化/单位/数据源），逐字符差分刷新
+==============================================================================*/
+#ifndef __SCREEN_H
+#define __SCREEN_H
+
+#include <stdint.h>
+
+#define SCREEN_LINES    4
+#define SCREEN_COLUMNS  16
+
+// 格式化函数：把 source 指向的数据写入 buf（以 '\0' 结尾），返回字符数
+typedef uint8_t (*Screen_Format_t)(char *buf, const void *source);
+
+// 页面字段
+typedef struct {
+    uint8_t line;            // 行位置 1~4
+    uint8_t column;          // 起始列 1~16
+    uint8_t width;           // 数值区宽度，格式化结果不足时右侧补空格
+    Screen_Format_t format;  // 格式化函数，NULL 表示 source 为常量文本
+    const void *source;      // 数据源
+    const char *unit;        // 单位标签，紧跟数值区之后，可为 NULL
+} ScreenField_t;
+
+#define SCREEN_FIELD_COUNT(table)  ((uint8_t)(sizeof(table) / sizeof((table)[0])))
+
+void Screen_Clear(void);
+void Screen_Invalidate(void);
+void Screen_PutText(uint8_t line, uint8_t column, const char *text, uint8_t width);
+void Screen_Render(const ScreenField_t *fields, uint8_t count);
+
+#endif // __SCREEN_H
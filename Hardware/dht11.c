@@ -1,152 +1,232 @@
 #include "dht11.h"
+#include "Timebase.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
+#include "Prof.h"
+#include "Trace.h"
 
-// DHT11??????
-static void DHT11_Mode(uint8_t mode)
+#define DHT11_START_LOW_US      20000   // ʼźŵ͵ƽ 18ms
+#define DHT11_FRAME_TIMEOUT_US  10000   // ͷߵ 40 λԼ 5ms
+#define DHT11_BIT_THRESHOLD_US  100     // ½ؼڴֵΪ 1
+#define DHT11_POWERUP_MS        1000    // ϵȴȶ
+#define DHT11_PERIOD_MS         1000    // ԼÿתһΣƵȡֻõֵ
+#define DHT11_BACKOFF_MAX       3       // ʧ˱෭ 3 Σ8s
+#define DHT11_TRACE_START       0xFFFF  // ټ¼ȡʱ¼״̬
+// ½أӦʼ 1  + ÿλʼ 40  + ͵ƽ 1 
+#define DHT11_EDGE_COUNT        42
+
+// ȡ״̬
+#define DHT11_IDLE              0
+#define DHT11_STARTING          1       // ʼ͵ƽ
+#define DHT11_RECEIVING         2       // ½ؽ
+
+static volatile u8 dht_state = DHT11_IDLE;
+static u8  dht_edges;                   // յ½
+static u16 dht_last_edge;               // һ½ص TIM4 
+static u8  dht_data[5];
+static DHT11_Callback_t dht_callback;
+static u32 dht_ready_ms;                // ϵȶʱ
+static volatile u32 dht_next_ms;        // һζȡʱ
+static volatile DHT11_Sample_t dht_cache;
+
+/**
+  * @brief  us ΢ TIM4 CC1 жϣ16 λȽȻƣus  65535
+  */
+static void DHT11_SetTimeout(u16 us)
+{
+    TIM_SetCompare1(TIM4, (u16)(TIM_GetCounter(TIM4) + us));
+    TIM_ClearITPendingBit(TIM4, TIM_IT_CC1);
+    TIM_ITConfig(TIM4, TIM_IT_CC1, ENABLE);
+}
+
+/**
+  * @brief  »沢һζȡɹ 1 תڣʧܺʧܴ˱
+  */
+static void DHT11_Store(u8 status)
+{
+    u32 now = Time_Ms();
+    u8 shift = 0;
+
+    if (status == DHT11_OK) {
+        dht_cache.humidity = dht_data[0];
+        dht_cache.temperature = dht_data[2];
+        dht_cache.time_ms = now;
+        dht_cache.failures = 0;
+    } else {
+        if (dht_cache.failures < 0xFF) dht_cache.failures++;
+        shift = dht_cache.failures - 1;
+        if (shift > DHT11_BACKOFF_MAX) shift = DHT11_BACKOFF_MAX;
+    }
+    dht_next_ms = now + ((u32)DHT11_PERIOD_MS << shift);
+}
+
+/**
+  * @brief  ζȡ»沢ûصжеã
+  */
+static void DHT11_Finish(u8 status)
+{
+    DHT11_Callback_t callback = dht_callback;
+
+    EXTI->IMR &= ~EXTI_Line12;
+    TIM_ITConfig(TIM4, TIM_IT_CC1, DISABLE);
+    DHT11_Store(status);
+    dht_state = DHT11_IDLE;                     // صпһ
+    TRACE_MARK(TRACE_DHT11, status);
+    if (callback) callback(dht_data[0], dht_data[2], status);
+}
+
+// ʼDHT11©ͷţTIM4 1us ɼPB12 ½ EXTIȡʱſ
+void DHT11_Init(void)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
-    
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    EXTI_InitTypeDef EXTI_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB2PeriphClockCmd(DHT11_GPIO_CLK | RCC_APB2Periph_AFIO, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4, ENABLE);
+
     GPIO_InitStructure.GPIO_Pin = DHT11_GPIO_PIN;
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_OD;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    
-    if(mode == 1) // ????
-    {
-        GPIO_InitStructure.GPIO_Mode = GPIO_Mode_Out_PP;
-    }
-    else // ????
-    {
-        GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
-    }
-    
     GPIO_Init(DHT11_GPIO_PORT, &GPIO_InitStructure);
+    DHT11_High;
+
+    TIM_TimeBaseStructure.TIM_Prescaler = SystemCoreClock / 1000000 - 1;
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFF;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM4, &TIM_TimeBaseStructure);
+
+    TIM_OCStructInit(&TIM_OCInitStructure);
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;         // ֻȽϣ
+    TIM_OC1Init(TIM4, &TIM_OCInitStructure);
+    TIM_ITConfig(TIM4, TIM_IT_CC1, DISABLE);
+
+    GPIO_EXTILineConfig(GPIO_PortSourceGPIOB, GPIO_PinSource12);
+    EXTI_InitStructure.EXTI_Line = EXTI_Line12;
+    EXTI_InitStructure.EXTI_Mode = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;   // DISABLE ʱ⺯ֻ IMRд FTSR
+    EXTI_Init(&EXTI_InitStructure);
+    EXTI->IMR &= ~EXTI_Line12;                  // ½شãȡʱſж
+
+    // ȼ IrqPrio.h
+    NVIC_InitStructure.NVIC_IRQChannel = TIM4_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIO_DHT11;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = IRQ_SUBPRIO_DEFAULT;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = EXTI15_10_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    TIM_Cmd(TIM4, ENABLE);
+    dht_state = DHT11_IDLE;
+    dht_ready_ms = Time_Ms() + DHT11_POWERUP_MS;
+    dht_next_ms = dht_ready_ms;
+    dht_cache.time_ms = 0;
+    dht_cache.failures = 0;
 }
 
-// ??DHT11
-static void DHT11_Reset(void)
+/**
+  * @brief  һζȡأ callback жи
+  * @retval 0 1 һζȡδϵδ 1s
+  */
+u8 DHT11_Start(DHT11_Callback_t callback)
 {
-    DHT11_Mode(1); // ?????
-    GPIO_ResetBits(DHT11_GPIO_PORT, DHT11_GPIO_PIN); // ??
-    Delay_ms(20);  // ????18ms
-    GPIO_SetBits(DHT11_GPIO_PORT, DHT11_GPIO_PIN);   // ??
-    Delay_us(30);  // ??20-40us
+    if (dht_state != DHT11_IDLE || (int32_t)(Time_Ms() - dht_ready_ms) < 0) return 1;
+
+    dht_callback = callback;
+    dht_state = DHT11_STARTING;
+    TRACE_MARK(TRACE_DHT11, DHT11_TRACE_START);
+    DHT11_Low;
+    DHT11_SetTimeout(DHT11_START_LOW_US);
+    return 0;
 }
 
-// ??DHT11??
-static uint8_t DHT11_Check(void)
+u8 DHT11_IsBusy(void)
 {
-    uint8_t retry = 0;
-    
-    DHT11_Mode(0); // ?????
-    
-    // ??DHT11??(????80us??)
-    while(GPIO_ReadInputDataBit(DHT11_GPIO_PORT, DHT11_GPIO_PIN) && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    
-    if(retry >= 100) return 1; // ????
-    
-    retry = 0;
-    
-    // ??DHT11??(????80us??)
-    while(!GPIO_ReadInputDataBit(DHT11_GPIO_PORT, DHT11_GPIO_PIN) && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    
-    if(retry >= 100) return 1; // ????
-    
-    return 0; // ??
+    return dht_state != DHT11_IDLE;
 }
 
-// ?DHT11?????
-static uint8_t DHT11_Read_Bit(void)
+/**
+  * @brief  ڵãؾȷƻʱʱȡ
+  * @retval 0 1 δڻһζȡδ
+  */
+u8 DHT11_Poll(DHT11_Callback_t callback)
 {
-    uint8_t retry = 0;
-    
-    // ???????
-    while(GPIO_ReadInputDataBit(DHT11_GPIO_PORT, DHT11_GPIO_PIN) && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    
-    retry = 0;
-    
-    // ???????
-    while(!GPIO_ReadInputDataBit(DHT11_GPIO_PORT, DHT11_GPIO_PIN) && retry < 100)
-    {
-        retry++;
-        Delay_us(1);
-    }
-    
-    // ??40us?????
-    Delay_us(40);
-    
-    // ??????,????1,???0
-    if(GPIO_ReadInputDataBit(DHT11_GPIO_PORT, DHT11_GPIO_PIN))
-        return 1;
-    else
-        return 0;
+    if ((int32_t)(Time_Ms() - dht_next_ms) < 0) return 1;
+    return DHT11_Start(callback);
 }
 
-// ?DHT11??????
-static uint8_t DHT11_Read_Byte(void)
+/**
+  * @brief  ȡ棨жϸƣֶ֤һ£valid ǰʱ̼
+  */
+void DHT11_GetSample(DHT11_Sample_t *sample)
 {
-    uint8_t i, data = 0;
-    
-    for(i = 0; i < 8; i++)
-    {
-        data <<= 1;
-        data |= DHT11_Read_Bit();
-    }
-    
-    return data;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    sample->temperature = dht_cache.temperature;
+    sample->humidity = dht_cache.humidity;
+    sample->failures = dht_cache.failures;
+    sample->time_ms = dht_cache.time_ms;
+    __set_PRIMASK(primask);
+
+    sample->valid = sample->time_ms != 0 && Time_Ms() - sample->time_ms <= DHT11_STALE_MS;
 }
 
-// ???DHT11
-uint8_t DHT11_Init(void)
+/**
+  * @brief  TIM4 CC1ʼźŽʱͷ߿ʼգеΪʱ
+  */
+void TIM4_IRQHandler(void)
 {
-    // ??GPIO??
-    RCC_APB2PeriphClockCmd(DHT11_GPIO_CLK, ENABLE);
-    
-    // ??GPIO??
-    DHT11_Mode(1); // ???????
-    GPIO_SetBits(DHT11_GPIO_PORT, DHT11_GPIO_PIN); // ????????
-    
-    // ???????
-    Delay_ms(1000);
-    
-    // ?????????
-    DHT11_Reset();
-    return DHT11_Check();
+    ISR_ENTER(ISR_DHT11, (u16)(TIM_GetCounter(TIM4) - TIM_GetCapture1(TIM4)) * Time_CyclesPerUs());
+    TIM_ClearITPendingBit(TIM4, TIM_IT_CC1);
+
+    if (dht_state == DHT11_STARTING) {
+        for (u8 i = 0; i < 5; i++) dht_data[i] = 0;
+        dht_edges = 0;
+        EXTI_ClearITPendingBit(EXTI_Line12);
+        EXTI->IMR |= EXTI_Line12;
+        dht_state = DHT11_RECEIVING;
+        DHT11_High;                             // ͷߣԼ 20~40us Ӧ
+        DHT11_SetTimeout(DHT11_FRAME_TIMEOUT_US);
+    } else if (dht_state == DHT11_RECEIVING) {
+        DHT11_Finish(dht_edges == 0 ? DHT11_ERR_NO_RESPONSE : DHT11_ERR_TIMEOUT);
+    }
+
+    ISR_EXIT(ISR_DHT11);
 }
 
-// ?DHT11???????
-uint8_t DHT11_Read_Data(uint8_t *temperature, uint8_t *humidity)
+/**
+  * @brief  PB12 ½أһ½صļһλ
+  *          0 ½ΪӦʼ 1 Ϊ 1 λʼ֮ÿ½ؽһλ
+  */
+void EXTI15_10_IRQHandler(void)
 {
-    uint8_t buf[5];
-    uint8_t i;
-    
-    // ?????????
-    DHT11_Reset();
-    if(DHT11_Check() == 0)
-    {
-        // ??40?(5??)??
-        for(i = 0; i < 5; i++)
-        {
-            buf[i] = DHT11_Read_Byte();
-        }
-        
-        // ????
-        if((buf[0] + buf[1] + buf[2] + buf[3]) == buf[4])
-        {
-            *humidity = buf[0];
-            *temperature = buf[2];
-            return 0; // ??
+    u16 now = TIM_GetCounter(TIM4);
+    ISR_ENTER(ISR_DHT11, ISR_LATENCY_NONE);
+    PROF_BEGIN(PROF_DHT11);
+
+    if (EXTI_GetITStatus(EXTI_Line12) != RESET) {
+        EXTI_ClearITPendingBit(EXTI_Line12);
+        if (dht_state == DHT11_RECEIVING) {
+            if (dht_edges >= 2) {
+                u8 bit = dht_edges - 2;
+                if ((u16)(now - dht_last_edge) > DHT11_BIT_THRESHOLD_US) {
+                    dht_data[bit >> 3] |= 0x80 >> (bit & 7);
+                }
+            }
+            dht_last_edge = now;
+            if (++dht_edges == DHT11_EDGE_COUNT) {
+                u8 sum = dht_data[0] + dht_data[1] + dht_data[2] + dht_data[3];
+                DHT11_Finish(sum == dht_data[4] ? DHT11_OK : DHT11_ERR_CHECKSUM);
+            }
         }
     }
-    
-    return 1; // ??
+
+    PROF_END(PROF_DHT11);
+    ISR_EXIT(ISR_DHT11);
 }
@@ -2,7 +2,6 @@
 #define __DHT11_H
 
 #include "stm32f10x.h"                  // Device header
-#include "delay.h"
 
 /*****************絥Ƭ******************
 											STM32
@@ -25,21 +24,41 @@
 #define DHT11_GPIO_CLK   RCC_APB2Periph_GPIOB
 /*********************END**********************/
 
-//״̬
-#define OUT 1
-#define IN  0
-
-//DHT11ߵ͵ƽ
+//DHT11ߵ͵ƽ©ߵƽͷߣ
 #define DHT11_Low  GPIO_ResetBits(DHT11_GPIO_PORT,DHT11_GPIO_PIN)
 #define DHT11_High GPIO_SetBits(DHT11_GPIO_PORT,DHT11_GPIO_PIN)
 
+/*
+ * жȡռ CPU ȴ
+ *   DHT11_Start ߣTIM4 Ƚж 20ms ͷ߲ PB12 ½ EXTI
+ *   ÿ½ضȡ TIM4 1usõʱ½ؼԼ 78us Ϊ 0Լ 120us Ϊ 1
+ *    40 λʱжеûصص̣Ͷ¼
+ * 棺DHT11 ԼÿתһΣDHT11_Poll ֻڵʱȡɹ 1s
+ *   ʧʱ 1s2s4s8s ˱ܣ뻺棬DHT11_GetSample ʱȡ
+ * Ϊ©ģͷ
+ */
+#define DHT11_OK                0       // Уͨ
+#define DHT11_ERR_NO_RESPONSE   1       // ʼźźӦ
+#define DHT11_ERR_TIMEOUT       2       // ݲ
+#define DHT11_ERR_CHECKSUM      3       // Уʹ
+
+#define DHT11_STALE_MS          5000    // ʱûгɹȡֵΪʧЧ
+
+typedef struct {
+    u8  temperature;            // 棬һγɹȡֵ
+    u8  humidity;               // %
+    u8  valid;                  //  DHT11_STALE_MS гɹȡ
+    u8  failures;               // ʧܴ
+    u32 time_ms;                // һγɹȡʱ̣Time_MsδɹΪ 0
+} DHT11_Sample_t;
+
+// ɻصжģhumidity/temperature  status Ϊ DHT11_OK ʱЧ
+typedef void (*DHT11_Callback_t)(u8 humidity, u8 temperature, u8 status);
 
-u8 DHT11_Init(void);//ʼDHT11
-u8 DHT11_Read_Data(u8 *temp,u8 *humi);//ȡʪ
-u8 DHT11_Read_Byte(void);//ȡһֽڵ
-u8 DHT11_Read_Bit(void);//ȡһλ
-void DHT11_Mode(u8 mode);//DHT11ģʽ
-u8 DHT11_Check(void);//DHT11
-void DHT11_Rst(void);//λDHT11   
+void DHT11_Init(void);//ʼDHT11šTIM4EXTI12ϵ 1s ڲܶȡ
+u8 DHT11_Start(DHT11_Callback_t callback);//һζȡ0 1 ϴδδ
+u8 DHT11_IsBusy(void);
+u8 DHT11_Poll(DHT11_Callback_t callback);//ʱȡ0 1 δڻæ
+void DHT11_GetSample(DHT11_Sample_t *sample);
 
 #endif
@@ -1,112 +1,206 @@
 // ultrasonic.c
 #include "ultrasonic.h"
-#include "timer.h"
-#include "Delay.h"    // ?? Delay_us?Delay_ms
+#include "Timebase.h"
+#include "Event.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
+#include "Prof.h"
+#include "Trace.h"
 
-// ?????????,???? ECHO ?????
-u16 msHcCount = 0;
+#define ECHO_PERIOD_US    (ULTRASONIC_PERIOD_MS * 1000UL)
+
+// ڻز״̬TIM1 £ TRIG ʱص ECHO_WAIT
+#define ECHO_WAIT         0       // ȴ
+#define ECHO_HIGH         1       // Ѳأȴ½
+#define ECHO_DONE         2       // ѷ
+
+static volatile uint8_t  echo_state = ECHO_DONE;
+static volatile uint16_t echo_rise = 0;         // زֵus
+static volatile Ultrasonic_Sample_t echo_sample = {ULTRASONIC_INVALID, 0, 0};
+
+// زȣus루0.1cmĻϵQ16distance = width * k >> 16
+// k = c / 2 / 1000 * 65536 c = 331.3 * sqrt(1 + T / 273.15) m/sT = -20 ~ 50 
+// 20 ʱ k = 11246Լ 1/58.3 cm/usֻһγ˷λ
+static const uint16_t echo_scale_q16[ULTRASONIC_TEMP_MAX - ULTRASONIC_TEMP_MIN + 1] = {
+    10451, 10472, 10492, 10513, 10533, 10554, 10574, 10595,    // -20 ~ -13
+    10615, 10635, 10655, 10676, 10696, 10716, 10736, 10756,    // -12 ~ -5
+    10776, 10796, 10816, 10836, 10856, 10876, 10896, 10915,    // -4 ~ 3
+    10935, 10955, 10975, 10994, 11014, 11033, 11053, 11072,    // 4 ~ 11
+    11092, 11111, 11131, 11150, 11169, 11189, 11208, 11227,    // 12 ~ 19
+    11246, 11266, 11285, 11304, 11323, 11342, 11361, 11380,    // 20 ~ 27
+    11399, 11418, 11437, 11456, 11474, 11493, 11512, 11531,    // 28 ~ 35
+    11549, 11568, 11587, 11605, 11624, 11642, 11661, 11679,    // 36 ~ 43
+    11698, 11716, 11735, 11753, 11771, 11790, 11808,           // 44 ~ 50
+};
+static volatile uint16_t echo_scale = 11246;     // ǰ¶ȶӦϵĬ 20
+
+/**
+  * @brief  ֮΢ÿڴ 0 Ƶ ECHO_PERIOD_US-1
+  */
+static uint32_t Ultrasonic_Elapsed(uint16_t from, uint16_t to)
+{
+    return to >= from ? (uint32_t)(to - from) : (uint32_t)to + ECHO_PERIOD_US - from;
+}
 
 /**
-  * @brief  HC-SR04 ????????
-  *         TRIG: ???? 50MHz
-  *         ECHO: ????
+  * @brief  һΪͶ EVENT_ECHOжеã
+  * @param  distance: 0.1cmULTRASONIC_INVALID ʾ޻ز
+  * @param  age_us: ز½ؾڵ΢
+  */
+static void Ultrasonic_Publish(uint16_t distance, uint32_t age_us)
+{
+    echo_sample.distance = distance;
+    echo_sample.time_us = Time_Us() - age_us;
+    echo_sample.seq++;
+    Event_Post(EVENT_ECHO, 0, distance);
+    TRACE_MARK(TRACE_ULTRASONIC, distance);
+}
+
+/**
+  * @brief  HC-SR04 ʼTIM1 1us  ULTRASONIC_PERIOD_MS
+  *         TRIGPA8CH1 PWM1ÿڿͷ ULTRASONIC_TRIG_US ߵƽ
+  *         ECHOPA9CH2 벶жлؼ
   */
 void Ultrasonic_Init(void)
 {
     GPIO_InitTypeDef GPIO_InitStructure;
-    
-    // ?? GPIO ??
-    RCC_APB2PeriphClockCmd(ULTRASONIC_GPIO_CLK, ENABLE);
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+    TIM_ICInitTypeDef TIM_ICInitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    RCC_APB2PeriphClockCmd(ULTRASONIC_GPIO_CLK | RCC_APB2Periph_TIM1, ENABLE);
 
-    // ?? TRIG ???????,50MHz
+    // TRIG
     GPIO_InitStructure.GPIO_Pin   = ULTRASONIC_TRIG_GPIO_PIN;
-    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_Out_PP;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_AF_PP;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(ULTRASONIC_GPIO_PORT, &GPIO_InitStructure);
 
-    // ?? ECHO ???????
+    // ECHO
     GPIO_InitStructure.GPIO_Pin   = ULTRASONIC_ECHO_GPIO_PIN;
     GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_IN_FLOATING;
-    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
     GPIO_Init(ULTRASONIC_GPIO_PORT, &GPIO_InitStructure);
 
-    // ??????,???????
-    msHcCount = 0;
-    TIM4_Int_Init(1000 - 1, 72 - 1);
+    TIM_TimeBaseStructure.TIM_Prescaler = SystemCoreClock / 1000000 - 1;
+    TIM_TimeBaseStructure.TIM_Period = ECHO_PERIOD_US - 1;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
+
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_PWM1;           // CNT < CCR1 ʱߵƽ
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Enable;
+    TIM_OCInitStructure.TIM_OutputNState = TIM_OutputNState_Disable;
+    TIM_OCInitStructure.TIM_Pulse = ULTRASONIC_TRIG_US;
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OCInitStructure.TIM_OCNPolarity = TIM_OCNPolarity_High;
+    TIM_OCInitStructure.TIM_OCIdleState = TIM_OCIdleState_Reset;
+    TIM_OCInitStructure.TIM_OCNIdleState = TIM_OCNIdleState_Reset;
+    TIM_OC1Init(TIM1, &TIM_OCInitStructure);
+    TIM_OC1PreloadConfig(TIM1, TIM_OCPreload_Enable);
+
+    TIM_ICInitStructure.TIM_Channel = TIM_Channel_2;
+    TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;
+    TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_DirectTI;
+    TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStructure.TIM_ICFilter = 0x03;                    // 8 ʱ˲
+    TIM_ICInit(TIM1, &TIM_ICInitStructure);
+
+    TIM_ClearFlag(TIM1, TIM_FLAG_Update | TIM_FLAG_CC2);
+    TIM_ITConfig(TIM1, TIM_IT_Update | TIM_IT_CC2, ENABLE);
+
+    // ȼ IrqPrio.h
+    NVIC_InitStructure.NVIC_IRQChannel = TIM1_UP_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIO_ECHO_CAPTURE;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = IRQ_SUBPRIO_DEFAULT;
+    NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = TIM1_CC_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+
+    TIM_Cmd(TIM1, ENABLE);
+    TIM_CtrlPWMOutputs(TIM1, ENABLE);                           // ߼ʱ
 }
 
 /**
-  * @brief  ?????,???? ECHO ?????
+  * @brief  û¶ȣ֮¶µٻ㣨Χȡ˵㣩
+  * @param  celsius: ¶ 棨һΪ DHT11 һζ
   */
-static void OpenTimerForHc(void)
+void Ultrasonic_SetTemperature(int16_t celsius)
 {
-    TIM_SetCounter(TIM4, 0);
-    msHcCount = 0;
-    TIM_Cmd(TIM4, ENABLE);
+    if (celsius < ULTRASONIC_TEMP_MIN) celsius = ULTRASONIC_TEMP_MIN;
+    if (celsius > ULTRASONIC_TEMP_MAX) celsius = ULTRASONIC_TEMP_MAX;
+    echo_scale = echo_scale_q16[celsius - ULTRASONIC_TEMP_MIN];
 }
 
 /**
-  * @brief  ?????
+  * @brief  ȡһβжϸƣֶ֤һ£
   */
-static void CloseTimerForHc(void)
+void Ultrasonic_GetSample(Ultrasonic_Sample_t *sample)
 {
-    TIM_Cmd(TIM4, DISABLE);
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    sample->distance = echo_sample.distance;
+    sample->time_us = echo_sample.time_us;
+    sample->seq = echo_sample.seq;
+    __set_PRIMASK(primask);
 }
 
 /**
-  * @brief  ???????(??????)
-  * @retval ????? (s)
+  * @brief  һβõľ루cm޻ز -1.0fȴ
   */
-u32 GetEchoTimer(void)
+float UltrasonicGetLength(void)
 {
-    u32 t = msHcCount * 1000 + TIM_GetCounter(TIM4);
-    TIM4->CNT = 0;
-    Delay_ms(50);  // ?????
-    return t;
+    uint16_t distance = echo_sample.distance;
+    return distance == ULTRASONIC_INVALID ? -1.0f : distance / 10.0f;
 }
 
 /**
-  * @brief  ????????(??:cm)
-  *         ????????,??????,???? -1.0f
-  * @retval ??? (cm) ?????? -1.0f
+  * @brief  TIM1 £һ TRIG ʼһûز򷢲Ч
   */
-float UltrasonicGetLength(void)
+void TIM1_UP_IRQHandler(void)
 {
-    u32 t;
-    float sum = 0.0f;
-
-    for (int i = 0; i < 5; i++)
-    {
-        // ? 20s ????
-        TRIG_Send = 1;
-        Delay_us(20);
-        TRIG_Send = 0;
-
-        // ?? ECHO ????,??? 60ms
-        u32 timeout = 60000;
-        while (ECHO_Reci == 0 && timeout--) {
-            Delay_us(1);
-        }
-        if (timeout == 0) {
-            return -1.0f;  // ?????????
-        }
+    ISR_ENTER(ISR_TIM1, TIM1->CNT * Time_CyclesPerUs());
+    TIM_ClearITPendingBit(TIM1, TIM_IT_Update);
+    if (echo_state != ECHO_DONE) {
+        Ultrasonic_Publish(ULTRASONIC_INVALID, 0);
+    }
+    echo_state = ECHO_WAIT;
+    TIM1->CCER &= (uint16_t)~TIM_CCER_CC2P;                      // صز
+    ISR_EXIT(ISR_TIM1);
+}
 
-        OpenTimerForHc();
+/**
+  * @brief  TIM1 CH2 ؼ㲢Ϊ½أ½ؼز
+  *         ڻزǰл 2cm ĻزԼ 120us
+  *          =    / 2ϵ¶ȲUltrasonic_SetTemperature
+  */
+void TIM1_CC_IRQHandler(void)
+{
+    uint16_t capture = TIM1->CCR2;                              // ȡͬʱ CC2IF
+    ISR_ENTER(ISR_TIM1, Ultrasonic_Elapsed(capture, TIM1->CNT) * Time_CyclesPerUs());
+    PROF_BEGIN(PROF_ULTRASONIC);
 
-        // ?? ECHO ????,??? 60ms
-        timeout = 60000;
-        while (ECHO_Reci == 1 && timeout--) {
-            Delay_us(1);
+    if (TIM1->CCER & TIM_CCER_CC2P) {
+        // ½
+        TIM1->CCER &= (uint16_t)~TIM_CCER_CC2P;
+        if (echo_state == ECHO_HIGH) {
+            uint32_t width = Ultrasonic_Elapsed(echo_rise, capture);
+            uint16_t distance = width > ULTRASONIC_ECHO_MAX_US ?
+                                ULTRASONIC_INVALID : (uint16_t)((width * echo_scale + 0x8000) >> 16);
+            Ultrasonic_Publish(distance, Ultrasonic_Elapsed(capture, TIM1->CNT));
+            echo_state = ECHO_DONE;
         }
-        CloseTimerForHc();
-        if (timeout == 0) {
-            return -1.0f;  // ?????????
+    } else {
+        // 
+        TIM1->CCER |= TIM_CCER_CC2P;
+        if (echo_state == ECHO_WAIT) {
+            echo_rise = capture;
+            echo_state = ECHO_HIGH;
         }
-
-        // ????????????????? cm
-        t = GetEchoTimer();
-        sum += ((float)t) / 58.0f;
     }
 
-    return (sum / 5.0f);
+    PROF_END(PROF_ULTRASONIC);
+    ISR_EXIT(ISR_TIM1);
 }
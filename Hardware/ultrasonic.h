@@ -1,9 +1,6 @@
 #ifndef __ULTRASONIC_H
 #define	__ULTRASONIC_H
 #include "stm32f10x.h"
-#include "adcx.h"
-#include "Delay.h"
-#include "math.h"
 
 /*****************???????******************
 											STM32
@@ -18,25 +15,35 @@
 
 **********************BEGIN***********************/
 
-
-/***************????????****************/
-// ULTRASONIC GPIO???
+/***************Լ****************/
+// ULTRASONIC GPIO궨壨PA8/PA9 Ϊ TIM1_CH1/TIM1_CH2ӳ䣩
 
 #define		ULTRASONIC_GPIO_CLK								RCC_APB2Periph_GPIOA
 #define 	ULTRASONIC_GPIO_PORT							GPIOA
 #define 	ULTRASONIC_TRIG_GPIO_PIN					GPIO_Pin_8	
 #define 	ULTRASONIC_ECHO_GPIO_PIN					GPIO_Pin_9	
 
-#define 	TRIG_Send  PAout(8)
-#define 	ECHO_Reci  PAin(9)
+// TIM1 ӲࣺCH1 ÿ TRIG 壬CH2 벶 ECHO /½أ
+// жϼ벢Ͷݴʱ EVENT_ECHO ¼ȡһνȴ
+//  50ms20HzHC-SR04 ϰʱ ECHO ߵƽԼ 38msڲӦС 40ms
+#define		ULTRASONIC_PERIOD_MS		50
+#define		ULTRASONIC_TRIG_US			10			// TRIG ߵƽ
+#define		ULTRASONIC_ECHO_MAX_US		30000		// ز 30msԼ 5mΪϰ
+#define		ULTRASONIC_INVALID			0xFFFF		// Чز EVENT_VALUE_INVALID ͬ
+#define		ULTRASONIC_TEMP_MIN			(-20)		// ¶ȲΧ 
+#define		ULTRASONIC_TEMP_MAX			50
 
 /*********************END**********************/
 
+typedef struct {
+	uint16_t distance;			// 0.1cmULTRASONIC_INVALID ʾ޻ز
+	uint32_t time_us;			// ز½ʱ̣Time_Us
+	uint32_t seq;				// ѷ
+} Ultrasonic_Sample_t;
+
 void Ultrasonic_Init(void);
 float UltrasonicGetLength(void);
-
-void OpenTimerForHc(void);
-void CloseTimerForHc(void); 
-u32 GetEchoTimer(void);
+void Ultrasonic_GetSample(Ultrasonic_Sample_t *sample);
+void Ultrasonic_SetTemperature(int16_t celsius);
 
 #endif /* __ULTRASONIC_H */
@@ -23,45 +23,26 @@ void Delay_s(uint32_t s);
 #include "stm32f10x.h"
 #include "system_stm32f10x.h"
 #include "Delay.h"
-
-static uint32_t fac_us;  // 微秒延时时钟倍数
-static uint32_t fac_ms;  // 毫秒延时时钟倍数
+#include "Timebase.h"
 
 /**
-  * @brief  延时模块初始化
+  * @brief  延时模块初始化（启动统一时基）
   * @note   必须在 SystemCoreClockUpdate() 之后调用
   */
 void Delay_Init(void)
 {
-    // 配置 SysTick 时钟源为 HCLK
-    SysTick_CLKSourceConfig(SysTick_CLKSource_HCLK);
-    // 计算延时倍数
-    fac_us = SystemCoreClock / 1000000;
-    fac_ms = fac_us * 1000;
+    Time_Init();
 }
 
 /**
-  * @brief  微秒延时
-  * @param  us: 需要延时的微秒数
+  * @brief  微秒延时：等待 DWT 周期计数到期，不改动 SysTick
+  * @param  us: 需要延时的微秒数（单次不超过约 59s）
   */
 void Delay_us(uint32_t us)
 {
-    uint32_t cnt = us * fac_us;
-    // 大于 24 位最大值分段延时
-    while (cnt > 0x00FFFFFF)
-    {
-        SysTick->LOAD = 0x00FFFFFF;
-        SysTick->VAL  = 0;
-        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
-        while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk));
-        cnt -= 0x00FFFFFF;
-    }
-    SysTick->LOAD = cnt;
-    SysTick->VAL  = 0;
-    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
-    while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk));
-    SysTick->CTRL = 0;
-    SysTick->VAL  = 0;
+    uint32_t start = Time_Cycles();
+    uint32_t cycles = us * Time_CyclesPerUs();
+    while (Time_Cycles() - start < cycles);
 }
 
 /**
@@ -70,21 +51,10 @@ void Delay_us(uint32_t us)
   */
 void Delay_ms(uint32_t ms)
 {
-    uint32_t cnt = ms * fac_ms;
-    while (cnt > 0x00FFFFFF)
+    while (ms--)
     {
-        SysTick->LOAD = 0x00FFFFFF;
-        SysTick->VAL  = 0;
-        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
-        while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk));
-        cnt -= 0x00FFFFFF;
+        Delay_us(1000);
     }
-    SysTick->LOAD = cnt;
-    SysTick->VAL  = 0;
-    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
-    while (!(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk));
-    SysTick->CTRL = 0;
-    SysTick->VAL  = 0;
 }
 
 /**
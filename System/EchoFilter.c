@@ -0,0 +1,115 @@
+/*==============================================================================
+  文件：EchoFilter.c
+  功能：超声测距中值/Hampel 滤波
+        ECHO_FILTER_NONE 数值最大，排序后自然排在最后：窗口中多数为无回波时中值
+        即为“无障碍”，少数无回波只相当于一个很远的离群点
+==============================================================================*/
+#include "EchoFilter.h"
+
+/**
+  * @brief  读数限幅：过近按最小值，过远或无回波按无障碍
+  */
+static uint16_t EchoFilter_Clamp(uint16_t raw)
+{
+    if (raw == ECHO_FILTER_NONE || raw > ECHO_FILTER_MAX) return ECHO_FILTER_NONE;
+    if (raw < ECHO_FILTER_MIN) return ECHO_FILTER_MIN;
+    return raw;
+}
+
+static uint16_t EchoFilter_Diff(uint16_t a, uint16_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+/**
+  * @brief  插入排序后取中值（n 不超过 ECHO_FILTER_SIZE）
+  */
+static uint16_t EchoFilter_Median(uint16_t *v, uint8_t n)
+{
+    for (uint8_t i = 1; i < n; i++) {
+        uint16_t x = v[i];
+        uint8_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+    return v[n / 2];
+}
+
+void EchoFilter_Init(EchoFilter_t *f)
+{
+    f->head = 0;
+    f->count = 0;
+    f->distance = ECHO_FILTER_NONE;
+    f->threshold = ECHO_FILTER_TOLERANCE;
+    f->confidence = 0;
+    f->time_us = 0;
+    f->samples = 0;
+    f->outliers = 0;
+}
+
+/**
+  * @brief  加入一个样本并更新输出
+  * @param  raw: 距离 0.1cm，ECHO_FILTER_NONE 表示无回波
+  * @param  time_us: 样本时刻
+  * @retval 滤波后的距离 0.1cm，ECHO_FILTER_NONE 表示无障碍
+  */
+uint16_t EchoFilter_Add(EchoFilter_t *f, uint16_t raw, uint32_t time_us)
+{
+    uint16_t sorted[ECHO_FILTER_SIZE];
+    uint16_t sample = EchoFilter_Clamp(raw);
+    uint16_t median, mad;
+    uint32_t threshold;
+    uint8_t n, inliers = 0;
+
+    f->window[f->head] = sample;
+    f->head = (f->head + 1) % ECHO_FILTER_SIZE;
+    if (f->count < ECHO_FILTER_SIZE) f->count++;
+    f->samples++;
+    n = f->count;
+
+    for (uint8_t i = 0; i < n; i++) sorted[i] = f->window[i];
+    median = EchoFilter_Median(sorted, n);
+
+    // Hampel 门限：3 × 1.4826 × MAD ≈ MAD × 4.45
+    for (uint8_t i = 0; i < n; i++) sorted[i] = EchoFilter_Diff(f->window[i], median);
+    mad = EchoFilter_Median(sorted, n);
+    threshold = (uint32_t)mad * 89 / 20;
+    if (threshold < ECHO_FILTER_TOLERANCE) threshold = ECHO_FILTER_TOLERANCE;
+    if (threshold > ECHO_FILTER_MAX) threshold = ECHO_FILTER_MAX;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (EchoFilter_Diff(f->window[i], median) <= threshold) inliers++;
+    }
+
+    f->distance = median;
+    f->threshold = (uint16_t)threshold;
+    f->confidence = (uint8_t)(inliers * 100 / ECHO_FILTER_SIZE);
+    if (EchoFilter_Diff(sample, median) <= threshold) {
+        f->time_us = time_us;
+    } else {
+        f->outliers++;
+    }
+    return median;
+}
+
+/**
+  * @brief  当前输出；超过 ECHO_FILTER_STALE_US 没有一致的样本时返回 ECHO_FILTER_NONE
+  */
+uint16_t EchoFilter_Distance(const EchoFilter_t *f, uint32_t now_us)
+{
+    if (f->count == 0 || EchoFilter_Age(f, now_us) > ECHO_FILTER_STALE_US) {
+        return ECHO_FILTER_NONE;
+    }
+    return f->distance;
+}
+
+/**
+  * @brief  距最近一个与输出一致的样本的时间 us
+  */
+uint32_t EchoFilter_Age(const EchoFilter_t *f, uint32_t now_us)
+{
+    return now_us - f->time_us;
+}
@@ -0,0 +1,39 @@
+/*==============================================================================
+  文件：EchoFilter.h
+  功能：超声测距流式滤波
+        每个样本进入最近 N 个样本的环形窗口，输出窗口中值；偏离中值超过
+        Hampel 门限（约 3 倍标准差，由 MAD 估计，不低于 ECHO_FILTER_TOLERANCE）
+        的样本记为离群，不更新时间戳。无回波样本视为“无障碍”参与中值，
+        因此单次超时或单次杂波都不会改变输出。
+        全部为整数运算（距离单位 0.1cm），不依赖芯片，主机上可直接编译测试
+==============================================================================*/
+#ifndef __ECHOFILTER_H
+#define __ECHOFILTER_H
+
+#include <stdint.h>
+
+#define ECHO_FILTER_SIZE        5           // 窗口样本数（奇数）
+#define ECHO_FILTER_NONE        0xFFFF      // 无障碍/无有效数据，与 EVENT_VALUE_INVALID 相同
+#define ECHO_FILTER_MIN         20          // 2.0cm，更近的读数按此值处理
+#define ECHO_FILTER_MAX         4000        // 400.0cm，更远的读数按无障碍处理
+#define ECHO_FILTER_TOLERANCE   100         // 离群门限下限 10.0cm
+#define ECHO_FILTER_STALE_US    500000      // 超过此时间没有与输出一致的样本视为失效
+
+typedef struct {
+    uint16_t window[ECHO_FILTER_SIZE];      // 最近样本，0.1cm 或 ECHO_FILTER_NONE
+    uint8_t  head;                          // 下一个写入位置
+    uint8_t  count;                         // 窗口中的样本数
+    uint16_t distance;                      // 滤波输出 0.1cm，ECHO_FILTER_NONE 表示无障碍
+    uint16_t threshold;                     // 当前离群门限 0.1cm
+    uint8_t  confidence;                    // 窗口中与输出一致的样本占比 %
+    uint32_t time_us;                       // 最近一个与输出一致的样本时刻
+    uint32_t samples;                       // 累计样本数
+    uint32_t outliers;                      // 累计离群样本数
+} EchoFilter_t;
+
+void     EchoFilter_Init(EchoFilter_t *f);
+uint16_t EchoFilter_Add(EchoFilter_t *f, uint16_t raw, uint32_t time_us);
+uint16_t EchoFilter_Distance(const EchoFilter_t *f, uint32_t now_us);
+uint32_t EchoFilter_Age(const EchoFilter_t *f, uint32_t now_us);
+
+#endif // __ECHOFILTER_H
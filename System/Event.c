@@ -0,0 +1,116 @@
+/*==============================================================================
+  文件：Event.c
+  功能：多生产者、单消费者的无锁事件队列
+        reserve 为已预留的槽位数，由生产者用 LDREX/STREX 递增；中断在两条指令
+        之间发生时 STREX 失败并重试，因此嵌套的中断也能安全投递
+        tail 只由消费者修改；槽位的 ready 标志保证消费者不会读到写了一半的事件
+        单核 Cortex-M3 上内存写按程序顺序对中断可见，槽位声明为 volatile 即可保证顺序
+==============================================================================*/
+#include "Event.h"
+
+#ifndef EVENT_HOST
+#include "stm32f10x.h"
+#include "Timebase.h"
+#define EVENT_NOW()     Time_Us()
+#else
+// 主机模型：无并发，用普通读写代替独占访问
+extern uint32_t event_host_now;
+#define EVENT_NOW()     event_host_now
+#define __LDREXW(p)     (*(p))
+#define __STREXW(v, p)  ((*(p) = (v)), 0)
+#define __CLREX()
+#endif
+
+#define EVENT_MASK      (EVENT_QUEUE_SIZE - 1)
+
+typedef struct {
+    uint8_t ready;
+    Event_t event;
+} EventSlot_t;
+
+static volatile EventSlot_t slots[EVENT_QUEUE_SIZE];
+static volatile uint32_t reserve = 0;   // 生产者预留的槽位总数
+static volatile uint32_t tail = 0;      // 消费者已取出的事件总数
+static volatile uint32_t dropped = 0;
+static uint8_t max_used = 0;
+
+/**
+  * @brief  原子加一（LDREX/STREX）
+  */
+static void Event_AtomicInc(volatile uint32_t *value)
+{
+    uint32_t v;
+    do {
+        v = __LDREXW((uint32_t *)value);
+    } while (__STREXW(v + 1, (uint32_t *)value));
+}
+
+void Event_Init(void)
+{
+    for (uint8_t i = 0; i < EVENT_QUEUE_SIZE; i++) {
+        slots[i].ready = 0;
+    }
+    reserve = 0;
+    tail = 0;
+    dropped = 0;
+    max_used = 0;
+}
+
+/**
+  * @brief  投递事件，可在任意中断或线程中调用
+  * @retval 1 成功，0 队列已满（计入丢弃数）
+  */
+uint8_t Event_Post(uint8_t type, uint8_t arg, uint16_t value)
+{
+    uint32_t index;
+    volatile EventSlot_t *slot;
+
+    // 预留槽位
+    do {
+        index = __LDREXW((uint32_t *)&reserve);
+        if (index - tail >= EVENT_QUEUE_SIZE) {
+            __CLREX();
+            Event_AtomicInc(&dropped);
+            return 0;
+        }
+    } while (__STREXW(index + 1, (uint32_t *)&reserve));
+
+    slot = &slots[index & EVENT_MASK];
+    slot->event.type = type;
+    slot->event.arg = arg;
+    slot->event.value = value;
+    slot->event.time_us = EVENT_NOW();
+    slot->ready = 1;
+    return 1;
+}
+
+/**
+  * @brief  按投递顺序取出一个事件（只允许一个线程调用）
+  * @retval 1 取到事件，0 队列空或下一个槽位尚未写完
+  */
+uint8_t Event_Get(Event_t *event)
+{
+    volatile EventSlot_t *slot = &slots[tail & EVENT_MASK];
+    uint32_t used = reserve - tail;
+
+    if (used == 0 || !slot->ready) return 0;
+    if (used > max_used) max_used = used;
+
+    event->type = slot->event.type;
+    event->arg = slot->event.arg;
+    event->value = slot->event.value;
+    event->time_us = slot->event.time_us;
+    slot->ready = 0;
+    tail = tail + 1;    // 释放槽位，之后生产者才能重新预留
+    return 1;
+}
+
+uint32_t Event_GetDropped(void)
+{
+    return dropped;
+}
+
+uint8_t Event_GetMaxUsed(void)
+{
+    return max_used;
+}
@@ -0,0 +1,40 @@
+/*==============================================================================
+  文件：Event.h
+  功能：中断到线程的事件队列（带类型和微秒时间戳）
+        多个中断/线程可同时投递，只有一个线程取出（控制线程每周期取空一次）
+        投递用 LDREX/STREX 预留槽位，不关中断；写完后置槽位就绪标志，
+        取出端按顺序读取，遇到尚未写完的槽位即停止，下次再取
+==============================================================================*/
+#ifndef __EVENT_H
+#define __EVENT_H
+
+#include <stdint.h>
+
+#define EVENT_QUEUE_SIZE    32      // 必须为 2 的幂
+
+// 事件类型
+#define EVENT_NONE          0
+#define EVENT_KEY_DOWN      1       // arg=按键号(1-4)
+#define EVENT_KEY_UP        2       // arg=按键号，value=按下时长 ms
+#define EVENT_KEY_LONG      3       // arg=按键号，达到长按时间
+#define EVENT_KEY_REPEAT    4       // arg=按键号，长按连发
+#define EVENT_WHEEL         5       // value=本批脉冲数，time=最后一个脉冲时刻
+#define EVENT_ECHO          6       // value=距离 0.1cm，EVENT_VALUE_INVALID 表示无回波
+#define EVENT_ADC           7       // value=光照百分比
+
+#define EVENT_VALUE_INVALID 0xFFFF
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  arg;
+    uint16_t value;
+    uint32_t time_us;               // 投递时刻（Time_Us）
+} Event_t;
+
+void     Event_Init(void);
+uint8_t  Event_Post(uint8_t type, uint8_t arg, uint16_t value);
+uint8_t  Event_Get(Event_t *event);
+uint32_t Event_GetDropped(void);    // 队列满丢弃的事件数
+uint8_t  Event_GetMaxUsed(void);    // 取出时观察到的最大积压
+
+#endif // __EVENT_H
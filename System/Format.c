@@ -0,0 +1,111 @@
+/*==============================================================================
+  文件：Format.c
+  功能：显示用整数/定点数格式化，替代 sprintf 的 %d/%lu/%.1f
+==============================================================================*/
+#include "Format.h"
+
+/**
+  * @brief  把 len 个字符右对齐到 width，左侧补空格
+  * @param  buf: 已写入 len 个字符的缓冲
+  * @retval 最终长度
+  */
+static uint8_t Format_PadLeft(char *buf, uint8_t len, uint8_t width)
+{
+    if (len >= width) {
+        buf[len] = '\0';
+        return len;
+    }
+    uint8_t pad = width - len;
+    for (int8_t i = len - 1; i >= 0; i--) {
+        buf[i + pad] = buf[i];
+    }
+    for (uint8_t i = 0; i < pad; i++) {
+        buf[i] = ' ';
+    }
+    buf[width] = '\0';
+    return width;
+}
+
+/**
+  * @brief  写入无符号十进制数字（不补齐）
+  * @retval 写入的字符数
+  */
+static uint8_t Format_Digits(char *buf, uint32_t value)
+{
+    char tmp[10];
+    uint8_t n = 0;
+    do {
+        tmp[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    for (uint8_t i = 0; i < n; i++) {
+        buf[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+/**
+  * @brief  无符号整数
+  */
+uint8_t Format_UInt(char *buf, uint32_t value, uint8_t width)
+{
+    return Format_PadLeft(buf, Format_Digits(buf, value), width);
+}
+
+/**
+  * @brief  有符号整数
+  */
+uint8_t Format_Int(char *buf, int32_t value, uint8_t width)
+{
+    uint8_t len = 0;
+    if (value < 0) {
+        buf[len++] = '-';
+        len += Format_Digits(buf + len, 0u - (uint32_t)value);
+    } else {
+        len = Format_Digits(buf, (uint32_t)value);
+    }
+    return Format_PadLeft(buf, len, width);
+}
+
+/**
+  * @brief  定点一位小数
+  * @param  tenths: 数值×10
+  */
+uint8_t Format_Tenths(char *buf, int32_t tenths, uint8_t width)
+{
+    uint8_t len = 0;
+    uint32_t mag;
+    if (tenths < 0) {
+        buf[len++] = '-';
+        mag = 0u - (uint32_t)tenths;
+    } else {
+        mag = (uint32_t)tenths;
+    }
+    len += Format_Digits(buf + len, mag / 10);
+    buf[len++] = '.';
+    buf[len++] = (char)('0' + mag % 10);
+    return Format_PadLeft(buf, len, width);
+}
+
+/**
+  * @brief  无效值占位
+  */
+uint8_t Format_Invalid(char *buf, uint8_t width)
+{
+    buf[0] = buf[1] = buf[2] = buf[3] = '-';
+    return Format_PadLeft(buf, 4, width);
+}
+
+/**
+  * @brief  复制字符串
+  */
+uint8_t Format_Str(char *buf, const char *str)
+{
+    uint8_t n = 0;
+    while (str[n] != '\0') {
+        buf[n] = str[n];
+        n++;
+    }
+    buf[n] = '\0';
+    return n;
+}
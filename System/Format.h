@@ -0,0 +1,23 @@
+#ifndef __FORMAT_H
+#define __FORMAT_H
+
+#include <stdint.h>
+
+// 轻量数字格式化：不用 sprintf/浮点，直接写入行缓冲并以 '\0' 结尾，返回写入的字符数
+
+// 无符号整数，右对齐，宽度不足左补空格（Width=0 表示不补齐）
+uint8_t Format_UInt(char *buf, uint32_t value, uint8_t width);
+
+// 有符号整数，右对齐，负数带 '-'
+uint8_t Format_Int(char *buf, int32_t value, uint8_t width);
+
+// 定点一位小数：tenths=123 输出 "12.3"，右对齐
+uint8_t Format_Tenths(char *buf, int32_t tenths, uint8_t width);
+
+// 无效值占位 "----"，右对齐
+uint8_t Format_Invalid(char *buf, uint8_t width);
+
+// 复制字符串，返回长度（便于拼接）
+uint8_t Format_Str(char *buf, const char *str);
+
+#endif
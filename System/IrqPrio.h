@@ -0,0 +1,32 @@
+/*==============================================================================
+  文件：IrqPrio.h
+  功能：中断优先级统一分配表
+        分组 2：抢占优先级 0~3（数值越小越高，可嵌套），子优先级 0~3（只决定同时挂起时的顺序）
+        main 在初始化任何外设前调用一次 NVIC_PriorityGroupConfig(IRQ_PRIORITY_GROUP)，
+        各模块只引用这里的宏，不再自行设置分组
+
+        抢占  中断                     说明
+        0     EXTI9_5（码盘 PA5）      脉冲时间戳决定车速精度，不能被其他中断推迟
+        1     TIM1_UP / TIM1_CC（超声）回波边沿由硬件捕获，但捕获上升沿后须在回波结束前
+                                       切换为下降沿（最近 2cm 约 120us）
+        1     TIM4 / EXTI15_10（DHT11）在中断中读计数器作为下降沿时间戳，0/1 两种位宽
+                                       相差约 40us，延迟须远小于此
+        2     TIM3（按键扫描 1ms）     消抖以毫秒计，可容忍数百微秒延迟
+        2     DMA1_CH4 / I2C2（OLED）  显存推送，仅硬件 I2C 模式
+        3     SysTick / PendSV         时基与线程切换，最低（SysTick_Config 与 Kernel_Start 设置）
+==============================================================================*/
+#ifndef __IRQPRIO_H
+#define __IRQPRIO_H
+
+#define IRQ_PRIORITY_GROUP      NVIC_PriorityGroup_2
+
+#define IRQ_PRIO_WHEEL          0       // EXTI9_5
+#define IRQ_PRIO_ECHO_CAPTURE   1       // TIM1_UP、TIM1_CC
+#define IRQ_PRIO_DHT11          1       // TIM4、EXTI15_10
+#define IRQ_PRIO_KEY_SCAN       2       // TIM3
+#define IRQ_PRIO_OLED           2       // DMA1_Channel4、I2C2_EV、I2C2_ER
+#define IRQ_PRIO_KERNEL         3       // SysTick、PendSV（仅说明，由硬件最低优先级实现）
+
+#define IRQ_SUBPRIO_DEFAULT     0
+
+#endif // __IRQPRIO_H
@@ -0,0 +1,131 @@
+/*==============================================================================
+  文件：IsrStat.c
+  功能：中断进入延迟、执行时间、嵌套深度统计与主栈（MSP）用量
+        嵌套总是后进先出，被嵌套的中断返回前外层不会继续执行，
+        因此深度计数用普通加减即可
+        主栈：启动时把当前 SP 以下的空闲部分填充为固定值，之后从栈底向上
+        数仍保持填充值的字，得到历史最大用量。内核启动后 MSP 只供中断使用
+==============================================================================*/
+#include "stm32f10x.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
+#include "Trace.h"
+
+#define MSP_FILL            0xDEADBEEF
+#define MSP_PAINT_MARGIN    16          // 当前 SP 以下保留不填充的字数
+
+typedef struct {
+    const char *name;
+    uint8_t priority;                   // 抢占优先级，见 IrqPrio.h
+    uint8_t has_latency;                // 能否测量进入延迟
+} IsrInfo_t;
+
+static const IsrInfo_t isr_info[ISR_COUNT] = {
+    {"SysT", IRQ_PRIO_KERNEL,       1},
+    {"TIM3", IRQ_PRIO_KEY_SCAN,     1},
+    {"TIM1", IRQ_PRIO_ECHO_CAPTURE, 1},
+    {"DHT ", IRQ_PRIO_DHT11,        1},
+    {"EXTI", IRQ_PRIO_WHEEL,        0},
+    {"OLED", IRQ_PRIO_OLED,         0},
+};
+
+static volatile IsrStat_t stats[ISR_COUNT];
+static volatile uint8_t depth = 0;
+static volatile uint8_t max_depth = 0;
+static uint32_t *msp_base = 0;          // 主栈最低地址
+
+/**
+  * @brief  填充主栈空闲区（须在 SystemInit 之后、开中断之前调用）
+  */
+void IsrStat_Init(void)
+{
+    uint32_t top = *(volatile uint32_t *)SCB->VTOR;    // 向量表第 0 项为初始 MSP
+    uint32_t *end = (uint32_t *)(__get_MSP() - MSP_PAINT_MARGIN * 4);
+
+    msp_base = (uint32_t *)(top - MSP_STACK_SIZE);
+    for (uint32_t *p = msp_base; p < end; p++) {
+        *p = MSP_FILL;
+    }
+    IsrStat_Reset();
+}
+
+void IsrStat_Enter(IsrStat_Id_t id, uint32_t latency)
+{
+    volatile IsrStat_t *s = &stats[id];
+    s->count++;
+    if (latency != ISR_LATENCY_NONE && latency > s->latency_max) {
+        s->latency_max = latency;
+    }
+    depth++;
+    if (depth > max_depth) max_depth = depth;
+    if (ISR_TRACE_MASK & (1u << id)) {
+        TRACE_BEGIN(TRACE_ISR, id);
+    }
+}
+
+void IsrStat_Exit(IsrStat_Id_t id, uint32_t cycles)
+{
+    if (cycles > stats[id].duration_max) stats[id].duration_max = cycles;
+    depth--;
+    if (ISR_TRACE_MASK & (1u << id)) {
+        TRACE_END(TRACE_ISR, id);
+    }
+}
+
+/**
+  * @brief  读取一个中断的统计（关中断复制，保证各字段一致）
+  */
+void IsrStat_Get(IsrStat_Id_t id, IsrStat_t *stat)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    stat->count = stats[id].count;
+    stat->latency_max = stats[id].latency_max;
+    stat->duration_max = stats[id].duration_max;
+    __set_PRIMASK(primask);
+
+    if (!isr_info[id].has_latency) {
+        stat->latency_max = ISR_LATENCY_NONE;
+    }
+}
+
+const char *IsrStat_GetName(IsrStat_Id_t id)
+{
+    return isr_info[id].name;
+}
+
+uint8_t IsrStat_GetPriority(IsrStat_Id_t id)
+{
+    return isr_info[id].priority;
+}
+
+uint8_t IsrStat_GetMaxNesting(void)
+{
+    return max_depth;
+}
+
+uint32_t IsrStat_GetMspUsed(void)
+{
+    uint32_t free_words = 0;
+    if (msp_base == 0) return 0;
+    while (free_words < MSP_STACK_SIZE / 4 && msp_base[free_words] == MSP_FILL) {
+        free_words++;
+    }
+    return MSP_STACK_SIZE - free_words * 4;
+}
+
+/**
+  * @brief  清零延迟/执行时间/嵌套统计（主栈用量只增不减，不清零）
+  */
+void IsrStat_Reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint8_t i = 0; i < ISR_COUNT; i++) {
+        stats[i].count = 0;
+        stats[i].latency_max = 0;
+        stats[i].duration_max = 0;
+    }
+    max_depth = 0;
+    __set_PRIMASK(primask);
+}
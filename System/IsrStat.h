@@ -0,0 +1,62 @@
+/*==============================================================================
+  文件：IsrStat.h
+  功能：中断进入延迟、执行时间、嵌套深度统计与主栈（MSP）用量
+        进入延迟 = 触发事件到中断函数第一条语句的周期数，只对能读出触发时刻的
+        中断统计：SysTick 由 VAL 倒计数得到，TIM3/TIM1 由计数器（1us/计数）得到，
+        TIM1 捕获、TIM4 比较中断为计数器与捕获/比较值之差
+        同一驱动的多个中断向量合并为一项（TIM1 更新与捕获、DHT11 的 TIM4 与 EXTI15_10、
+        OLED 的 DMA1_CH4 与 I2C2 事件/错误）
+        执行时间包含被更高抢占优先级中断嵌套的时间
+==============================================================================*/
+#ifndef __ISRSTAT_H
+#define __ISRSTAT_H
+
+#include <stdint.h>
+#include "Timebase.h"
+
+#define MSP_STACK_SIZE      0x400       // 与启动文件 Stack_Size 一致
+#define ISR_LATENCY_NONE    0xFFFFFFFF  // 无法测量进入延迟
+
+typedef enum {
+    ISR_SYSTICK = 0,
+    ISR_TIM3,
+    ISR_TIM1,
+    ISR_DHT11,
+    ISR_EXTI9_5,
+    ISR_OLED,
+    ISR_COUNT
+} IsrStat_Id_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t latency_max;       // 周期，ISR_LATENCY_NONE 表示不测量
+    uint32_t duration_max;      // 周期
+} IsrStat_t;
+
+// 产生跟踪记录（TRACE_ISR）的中断，按 IsrStat_Id_t 置位。SysTick 与 TIM3 按键扫描
+// 各 1kHz，每次一对记录，不到 0.1s 就会冲掉整个跟踪缓冲区，默认只统计不记录；
+// 需要时在工程 C/C++ Define 中覆盖
+#ifndef ISR_TRACE_MASK
+#define ISR_TRACE_MASK          (~((1u << ISR_SYSTICK) | (1u << ISR_TIM3)))
+#endif
+
+// 执行时间计数源，主机测试时可定义为虚拟计数
+#ifndef ISR_CYCLES
+#define ISR_CYCLES()            DWT_CYCCNT
+#endif
+
+// 放在中断函数开头/结尾，成对使用；latency 为已测得的进入延迟（周期）
+#define ISR_ENTER(id, latency)  uint32_t isr_start = ISR_CYCLES(); IsrStat_Enter(id, latency)
+#define ISR_EXIT(id)            IsrStat_Exit(id, ISR_CYCLES() - isr_start)
+
+void     IsrStat_Init(void);
+void     IsrStat_Enter(IsrStat_Id_t id, uint32_t latency);
+void     IsrStat_Exit(IsrStat_Id_t id, uint32_t cycles);
+void     IsrStat_Get(IsrStat_Id_t id, IsrStat_t *stat);
+const char *IsrStat_GetName(IsrStat_Id_t id);
+uint8_t  IsrStat_GetPriority(IsrStat_Id_t id);
+uint8_t  IsrStat_GetMaxNesting(void);
+uint32_t IsrStat_GetMspUsed(void);      // 主栈历史最大用量（字节）
+void     IsrStat_Reset(void);
+
+#endif // __ISRSTAT_H
@@ -0,0 +1,133 @@
+/*==============================================================================
+  文件：Jitter.c
+  功能：控制周期抖动与截止时间监测
+        只由被测线程调用 CycleStart/CycleEnd；其他线程通过 Jitter_GetStats 读取，
+        复制期间禁止抢占，保证读到的是同一时刻的一组数据
+        主机测试见 Tools/test_jitter.c（-D'JITTER_NOW()=host_us()' -DKERNEL_HOST）
+==============================================================================*/
+#include "Jitter.h"
+#include "Kernel.h"
+
+#ifndef JITTER_NOW
+#include "Timebase.h"
+#define JITTER_NOW()    Time_Us()
+#endif
+
+// 响应时间分档上限（us），1-2-5 序列
+static const uint32_t bucket_limits[JITTER_BUCKETS - 1] = {
+    50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000
+};
+
+static Jitter_Stats_t stats;
+static uint64_t period_sum;
+static uint32_t period_count;
+static uint32_t deadline;
+static uint32_t release_time;
+static uint32_t last_start;
+static uint8_t  has_last;
+static volatile uint8_t reset_request;
+
+static void Jitter_Clear(void)
+{
+    stats.cycles = 0;
+    stats.period_min = 0xFFFFFFFF;
+    stats.period_max = 0;
+    stats.period_mean = 0;
+    stats.latency_max = 0;
+    stats.response_max = 0;
+    stats.misses = 0;
+    for (uint8_t i = 0; i < JITTER_BUCKETS; i++) {
+        stats.histogram[i] = 0;
+    }
+    period_sum = 0;
+    period_count = 0;
+    has_last = 0;
+}
+
+/**
+  * @brief  初始化
+  * @param  deadline_us: 释放到输出完成的截止时间
+  */
+void Jitter_Init(uint32_t deadline_us)
+{
+    deadline = deadline_us;
+    reset_request = 0;
+    Jitter_Clear();
+}
+
+/**
+  * @brief  周期开始
+  * @param  release_us: 本周期的计划释放时刻（Time_Us 时基）
+  */
+void Jitter_CycleStart(uint32_t release_us)
+{
+    uint32_t now = JITTER_NOW();
+    uint32_t latency = now - release_us;
+
+    if (reset_request) {
+        reset_request = 0;
+        Jitter_Clear();
+    }
+
+    if (has_last) {
+        uint32_t period = now - last_start;
+        if (period < stats.period_min) stats.period_min = period;
+        if (period > stats.period_max) stats.period_max = period;
+        period_sum += period;
+        period_count++;
+    }
+    // 释放时刻由毫秒节拍换算，可能比实际开始晚几微秒，此时按 0 计
+    if ((int32_t)latency < 0) latency = 0;
+    if (latency > stats.latency_max) stats.latency_max = latency;
+
+    last_start = now;
+    has_last = 1;
+    release_time = release_us;
+}
+
+/**
+  * @brief  周期结束（输出已更新），记录响应时间
+  */
+void Jitter_CycleEnd(void)
+{
+    uint32_t response = JITTER_NOW() - release_time;
+    uint8_t bucket = 0;
+
+    if ((int32_t)response < 0) response = 0;
+    while (bucket < JITTER_BUCKETS - 1 && response >= bucket_limits[bucket]) {
+        bucket++;
+    }
+    stats.histogram[bucket]++;
+    if (response > stats.response_max) stats.response_max = response;
+    if (response > deadline) stats.misses++;
+    stats.cycles++;
+}
+
+/**
+  * @brief  读取统计（任意线程）
+  */
+void Jitter_GetStats(Jitter_Stats_t *out)
+{
+    Kernel_Lock();
+    *out = stats;
+    if (period_count > 0) {
+        out->period_mean = (uint32_t)(period_sum / period_count);
+    } else {
+        out->period_min = 0;
+    }
+    Kernel_Unlock();
+}
+
+/**
+  * @brief  清零统计，在下一个周期开始时生效
+  */
+void Jitter_Reset(void)
+{
+    reset_request = 1;
+}
+
+uint32_t Jitter_BucketLimit(uint8_t bucket)
+{
+    if (bucket >= JITTER_BUCKETS - 1) return 0;
+    return bucket_limits[bucket];
+}
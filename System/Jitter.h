@@ -0,0 +1,33 @@
+/*==============================================================================
+  文件：Jitter.h
+  功能：控制周期抖动与截止时间监测
+        每个控制周期开始/结束各打一次微秒时间戳，统计周期最小/最大/平均值、
+        释放到开始的延迟、释放到输出完成的响应时间直方图（1-2-5 对数分档）
+        以及超过截止时间的次数
+==============================================================================*/
+#ifndef __JITTER_H
+#define __JITTER_H
+
+#include <stdint.h>
+
+#define JITTER_BUCKETS  10      // 响应时间分档数，最后一档为超出上限
+
+typedef struct {
+    uint32_t cycles;            // 统计的周期数
+    uint32_t period_min;        // 相邻两次开始的间隔 us
+    uint32_t period_max;
+    uint32_t period_mean;
+    uint32_t latency_max;       // 释放到开始的最大延迟 us
+    uint32_t response_max;      // 释放到输出完成的最大时间 us
+    uint32_t misses;            // 响应时间超过截止时间的次数
+    uint32_t histogram[JITTER_BUCKETS];
+} Jitter_Stats_t;
+
+void     Jitter_Init(uint32_t deadline_us);
+void     Jitter_CycleStart(uint32_t release_us);
+void     Jitter_CycleEnd(void);
+void     Jitter_GetStats(Jitter_Stats_t *stats);
+void     Jitter_Reset(void);
+uint32_t Jitter_BucketLimit(uint8_t bucket);   // 该档上限 us（不含），最后一档返回 0
+
+#endif // __JITTER_H
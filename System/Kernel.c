@@ -0,0 +1,431 @@
+/*==============================================================================
+  文件：Kernel.c
+  功能：Cortex-M3 轻量抢占式内核
+        - 就绪线程中优先级最高者运行；需要切换时挂起 PendSV，在最低优先级异常中
+          保存 r4-r11 到当前线程栈（其余寄存器由硬件压栈），再恢复下一个线程
+        - SysTick 每 1ms 调用 Kernel_Tick 唤醒到期的线程
+        - 最低优先级线程（空闲线程）必须始终就绪，不得阻塞
+==============================================================================*/
+#include "Kernel.h"
+
+#ifndef KERNEL_HOST
+#include "stm32f10x.h"
+#include "Timebase.h"
+#define KERNEL_ENTER_CRITICAL()  uint32_t kernel_primask = __get_PRIMASK(); __disable_irq()
+#define KERNEL_EXIT_CRITICAL()   __set_PRIMASK(kernel_primask)
+#define KERNEL_PEND_SWITCH()     (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+#define KERNEL_NOW()             Time_Ms()
+#include "Trace.h"
+#define KERNEL_TRACE_SWITCH(t)   TRACE_MARK(TRACE_SWITCH, (t)->priority)
+#else
+// 主机模型：无中断，挂起切换即立即切换当前线程，时间由测试代码推进
+extern uint32_t kernel_host_now;
+#define KERNEL_ENTER_CRITICAL()
+#define KERNEL_EXIT_CRITICAL()
+#define KERNEL_PEND_SWITCH()     (kernel_current = kernel_next)
+#define KERNEL_NOW()             kernel_host_now
+#define KERNEL_TRACE_SWITCH(t)
+#endif
+
+#define KERNEL_STACK_FILL   0xDEADBEEF      // 栈初始填充，用于统计栈余量
+
+// PendSV 汇编访问，不能为 static
+Kernel_Thread_t *kernel_current = 0;
+Kernel_Thread_t *kernel_next = 0;
+volatile uint32_t kernel_switch_cycles = 0;
+volatile uint32_t kernel_switch_max = 0;
+
+static Kernel_Thread_t *kernel_threads[KERNEL_MAX_THREADS];
+static uint8_t kernel_count = 0;
+static uint8_t kernel_started = 0;
+static volatile uint8_t kernel_lock = 0;
+
+static uint8_t Kernel_Reached(uint32_t deadline)
+{
+    return (int32_t)(KERNEL_NOW() - deadline) >= 0;
+}
+
+/**
+  * @brief  选出优先级最高的就绪线程，必要时挂起 PendSV（须在临界区内调用）
+  */
+static void Kernel_Schedule(void)
+{
+    Kernel_Thread_t *best = 0;
+
+    if (!kernel_started || kernel_lock) return;
+
+    for (uint8_t i = 0; i < kernel_count; i++) {
+        Kernel_Thread_t *t = kernel_threads[i];
+        if (t->state == KERNEL_READY && (best == 0 || t->priority < best->priority)) {
+            best = t;
+        }
+    }
+    kernel_next = best;
+    if (best != kernel_current) {
+        KERNEL_TRACE_SWITCH(best);
+        KERNEL_PEND_SWITCH();
+    }
+}
+
+/**
+  * @brief  线程函数返回后进入此处，永久挂起
+  */
+static void Kernel_ThreadExit(void)
+{
+    KERNEL_ENTER_CRITICAL();
+    kernel_current->state = KERNEL_BLOCKED;
+    kernel_current->wait_obj = 0;
+    kernel_current->has_timeout = 0;
+    Kernel_Schedule();
+    KERNEL_EXIT_CRITICAL();
+    while (1);
+}
+
+/**
+  * @brief  让当前线程睡眠到 deadline；内核未启动或被锁定时忙等
+  */
+static void Kernel_SleepCurrent(uint32_t deadline)
+{
+    if (!kernel_started || kernel_lock) {
+        while (!Kernel_Reached(deadline));
+        return;
+    }
+    KERNEL_ENTER_CRITICAL();
+    kernel_current->wake_time = deadline;
+    kernel_current->state = KERNEL_SLEEPING;
+    Kernel_Schedule();
+    KERNEL_EXIT_CRITICAL();     // PendSV 在此处切换，到期后从这里继续
+}
+
+void Kernel_Init(void)
+{
+    kernel_count = 0;
+    kernel_started = 0;
+    kernel_lock = 0;
+    kernel_current = 0;
+    kernel_next = 0;
+}
+
+/**
+  * @brief  创建线程
+  * @param  thread: 线程控制块（静态分配）
+  * @param  name: 名称
+  * @param  entry: 线程函数，一般为不返回的循环
+  * @param  priority: 优先级，0 最高，各线程互不相同
+  * @param  stack: 线程栈（uint64_t 数组保证 8 字节对齐）
+  * @param  stack_bytes: 栈大小
+  */
+void Kernel_CreateThread(Kernel_Thread_t *thread, const char *name, Kernel_Entry_t entry,
+                         uint8_t priority, uint64_t *stack, uint32_t stack_bytes)
+{
+    uint32_t *base = (uint32_t *)stack;
+    uint32_t words = stack_bytes / 4;
+    uint32_t *sp = base + words;
+
+    if (kernel_count >= KERNEL_MAX_THREADS) return;
+
+    for (uint32_t i = 0; i < words; i++) {
+        base[i] = KERNEL_STACK_FILL;
+    }
+
+    // 初始栈帧：与异常返回时硬件出栈的顺序一致，之后是 r11~r4
+    *--sp = 0x01000000;                         // xPSR，Thumb 位
+    *--sp = (uint32_t)(uintptr_t)entry & ~1u;   // PC，异常返回时 bit0 须为 0，否则 UsageFault
+    *--sp = (uint32_t)(uintptr_t)Kernel_ThreadExit; // LR
+    for (uint8_t i = 0; i < 5; i++) {
+        *--sp = 0;                              // r12, r3, r2, r1, r0
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        *--sp = 0;                              // r11 ~ r4
+    }
+
+    thread->sp = sp;
+    thread->name = name;
+    thread->priority = priority;
+    thread->state = KERNEL_READY;
+    thread->wait_result = 0;
+    thread->has_timeout = 0;
+    thread->wake_time = 0;
+    thread->wait_obj = 0;
+    thread->stack_base = base;
+    thread->stack_words = words;
+
+    kernel_threads[kernel_count++] = thread;
+}
+
+/**
+  * @brief  SysTick 节拍：唤醒延时到期或等待超时的线程
+  */
+void Kernel_Tick(void)
+{
+    KERNEL_ENTER_CRITICAL();
+    for (uint8_t i = 0; i < kernel_count; i++) {
+        Kernel_Thread_t *t = kernel_threads[i];
+        if (t->state == KERNEL_SLEEPING ||
+            (t->state == KERNEL_BLOCKED && t->has_timeout)) {
+            if (Kernel_Reached(t->wake_time)) {
+                t->wait_result = 0;
+                t->wait_obj = 0;
+                t->state = KERNEL_READY;
+            }
+        }
+    }
+    Kernel_Schedule();
+    KERNEL_EXIT_CRITICAL();
+}
+
+void Kernel_Delay(uint32_t ms)
+{
+    if (ms == 0) return;
+    Kernel_SleepCurrent(KERNEL_NOW() + ms);
+}
+
+/**
+  * @brief  固定速率周期延时：*wake 按周期累加，已错过的整周期跳过
+  */
+void Kernel_DelayUntil(uint32_t *wake, uint32_t period)
+{
+    *wake += period;
+    while (Kernel_Reached(*wake)) {
+        *wake += period;
+    }
+    Kernel_SleepCurrent(*wake);
+}
+
+void Kernel_SleepUntil(uint32_t deadline)
+{
+    if (Kernel_Reached(deadline)) return;
+    Kernel_SleepCurrent(deadline);
+}
+
+/**
+  * @brief  禁止抢占（中断照常响应），用于时序严格的短操作；可嵌套
+  */
+void Kernel_Lock(void)
+{
+    KERNEL_ENTER_CRITICAL();
+    kernel_lock++;
+    KERNEL_EXIT_CRITICAL();
+}
+
+void Kernel_Unlock(void)
+{
+    KERNEL_ENTER_CRITICAL();
+    if (kernel_lock > 0) kernel_lock--;
+    Kernel_Schedule();
+    KERNEL_EXIT_CRITICAL();
+}
+
+Kernel_Thread_t *Kernel_Current(void)
+{
+    return kernel_current;
+}
+
+void Kernel_SemInit(Kernel_Sem_t *sem, uint16_t initial, uint16_t max)
+{
+    sem->count = initial;
+    sem->max = max;
+}
+
+/**
+  * @brief  等待信号量
+  * @param  timeout_ms: KERNEL_NO_WAIT / 毫秒数 / KERNEL_WAIT_FOREVER
+  * @retval 1 获得，0 超时
+  */
+uint8_t Kernel_SemWait(Kernel_Sem_t *sem, uint32_t timeout_ms)
+{
+    Kernel_Thread_t *self;
+
+    KERNEL_ENTER_CRITICAL();
+    if (sem->count > 0) {
+        sem->count--;
+        KERNEL_EXIT_CRITICAL();
+        return 1;
+    }
+    if (timeout_ms == KERNEL_NO_WAIT || !kernel_started || kernel_lock) {
+        KERNEL_EXIT_CRITICAL();
+        return 0;
+    }
+    self = kernel_current;
+    self->state = KERNEL_BLOCKED;
+    self->wait_obj = sem;
+    self->wait_result = 0;
+    self->has_timeout = (timeout_ms != KERNEL_WAIT_FOREVER);
+    self->wake_time = KERNEL_NOW() + timeout_ms;
+    Kernel_Schedule();
+    KERNEL_EXIT_CRITICAL();     // 在此阻塞，被 Post 或超时唤醒后继续
+
+    return self->wait_result;
+}
+
+/**
+  * @brief  释放信号量：有线程等待时直接交给优先级最高的等待者
+  */
+void Kernel_SemPost(Kernel_Sem_t *sem)
+{
+    Kernel_Thread_t *waiter = 0;
+
+    KERNEL_ENTER_CRITICAL();
+    for (uint8_t i = 0; i < kernel_count; i++) {
+        Kernel_Thread_t *t = kernel_threads[i];
+        if (t->state == KERNEL_BLOCKED && t->wait_obj == sem &&
+            (waiter == 0 || t->priority < waiter->priority)) {
+            waiter = t;
+        }
+    }
+    if (waiter) {
+        waiter->state = KERNEL_READY;
+        waiter->wait_obj = 0;
+        waiter->wait_result = 1;
+        Kernel_Schedule();
+    } else if (sem->count < sem->max) {
+        sem->count++;
+    }
+    KERNEL_EXIT_CRITICAL();
+}
+
+void Kernel_QueueInit(Kernel_Queue_t *q, uint32_t *buffer, uint16_t size)
+{
+    q->buffer = buffer;
+    q->size = size;
+    q->head = 0;
+    q->tail = 0;
+    q->used = 0;
+    Kernel_SemInit(&q->items, 0, size);
+}
+
+/**
+  * @brief  放入消息，不阻塞
+  * @retval 1 成功，0 队列已满
+  */
+uint8_t Kernel_QueuePut(Kernel_Queue_t *q, uint32_t msg)
+{
+    KERNEL_ENTER_CRITICAL();
+    if (q->used >= q->size) {
+        KERNEL_EXIT_CRITICAL();
+        return 0;
+    }
+    q->buffer[q->tail] = msg;
+    q->tail = (q->tail + 1) % q->size;
+    q->used++;
+    Kernel_SemPost(&q->items);
+    KERNEL_EXIT_CRITICAL();
+    return 1;
+}
+
+/**
+  * @brief  取出消息
+  * @retval 1 成功，0 超时
+  */
+uint8_t Kernel_QueueGet(Kernel_Queue_t *q, uint32_t *msg, uint32_t timeout_ms)
+{
+    if (!Kernel_SemWait(&q->items, timeout_ms)) return 0;
+
+    KERNEL_ENTER_CRITICAL();
+    *msg = q->buffer[q->head];
+    q->head = (q->head + 1) % q->size;
+    q->used--;
+    KERNEL_EXIT_CRITICAL();
+    return 1;
+}
+
+uint32_t Kernel_GetSwitchCycles(void)
+{
+    return kernel_switch_cycles;
+}
+
+uint32_t Kernel_GetMaxSwitchCycles(void)
+{
+    return kernel_switch_max;
+}
+
+/**
+  * @brief  按创建顺序取线程（诊断页遍历用）
+  * @retval 超出线程数时返回 0
+  */
+const Kernel_Thread_t *Kernel_GetThread(uint8_t index)
+{
+    return index < kernel_count ? kernel_threads[index] : 0;
+}
+
+uint32_t Kernel_GetStackFree(const Kernel_Thread_t *thread)
+{
+    uint32_t n = 0;
+    while (n < thread->stack_words && thread->stack_base[n] == KERNEL_STACK_FILL) {
+        n++;
+    }
+    return n * 4;
+}
+
+#ifndef KERNEL_HOST
+
+/**
+  * @brief  启动内核，切换到优先级最高的线程，不返回
+  */
+void Kernel_Start(void)
+{
+    NVIC_SetPriority(PendSV_IRQn, 0xFF);    // 最低优先级，所有中断处理完才切换
+
+    __disable_irq();
+    __set_PSP(0);                           // PSP=0 表示首次切换无需保存上下文
+    kernel_started = 1;
+    Kernel_Schedule();
+    __enable_irq();
+
+    while (1);                              // PendSV 立即切走，不会执行到这里
+}
+
+/**
+  * @brief  PendSV：保存当前线程 r4-r11 和 PSP，恢复 kernel_next
+  *         耗时（不含异常进入/退出的硬件压栈）记入 kernel_switch_cycles
+  */
+__asm void PendSV_Handler(void)
+{
+    IMPORT  kernel_current
+    IMPORT  kernel_next
+    IMPORT  kernel_switch_cycles
+    IMPORT  kernel_switch_max
+    PRESERVE8
+
+    CPSID   I
+    LDR     r3, =0xE0001004         ; DWT_CYCCNT
+    LDR     r12, [r3]
+    LDR     r2, =kernel_current
+    MRS     r0, PSP
+    CBZ     r0, PendSV_Restore      ; 首次切换
+    STMDB   r0!, {r4-r11}
+    LDR     r1, [r2]
+    STR     r0, [r1]                ; kernel_current->sp = PSP
+PendSV_Restore
+    LDR     r1, =kernel_next
+    LDR     r1, [r1]
+    STR     r1, [r2]                ; kernel_current = kernel_next
+    LDR     r0, [r1]
+    LDMIA   r0!, {r4-r11}
+    MSR     PSP, r0
+
+    LDR     r0, [r3]
+    SUB     r0, r0, r12
+    LDR     r1, =kernel_switch_cycles
+    STR     r0, [r1]
+    LDR     r1, =kernel_switch_max
+    LDR     r2, [r1]
+    CMP     r0, r2
+    IT      HI
+    STRHI   r0, [r1]
+
+    CPSIE   I
+    ORR     lr, lr, #0x04           ; 返回线程模式，使用 PSP
+    BX      lr
+    ALIGN
+}
+
+#else
+
+void Kernel_Start(void)
+{
+    kernel_started = 1;
+    Kernel_Schedule();
+}
+
+#endif
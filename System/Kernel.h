@@ -0,0 +1,81 @@
+/*==============================================================================
+  文件：Kernel.h
+  功能：Cortex-M3 轻量抢占式内核
+        固定优先级（每个优先级一个线程），PendSV 切换上下文，SysTick 1ms 节拍；
+        提供阻塞延时、计数信号量和消息队列。
+        主机单元测试：定义 KERNEL_HOST 编译，上下文切换以直接切换当前线程模拟
+        （Tools/test_kernel.c）
+==============================================================================*/
+#ifndef __KERNEL_H
+#define __KERNEL_H
+
+#include <stdint.h>
+
+#define KERNEL_MAX_THREADS   8
+#define KERNEL_NO_WAIT       0            // 不等待
+#define KERNEL_WAIT_FOREVER  0xFFFFFFFF   // 一直等待
+
+// 线程状态
+#define KERNEL_READY         0
+#define KERNEL_SLEEPING      1            // Kernel_Delay 等待到期
+#define KERNEL_BLOCKED       2            // 等待信号量，可带超时
+
+typedef void (*Kernel_Entry_t)(void);
+
+typedef struct {
+    uint32_t   *sp;             // 保存的 PSP，须为第一个成员（PendSV 汇编按偏移 0 访问）
+    const char *name;
+    uint8_t     priority;       // 0 最高
+    uint8_t     state;
+    uint8_t     wait_result;    // 1 等到信号量，0 超时
+    uint8_t     has_timeout;
+    uint32_t    wake_time;      // 延时/超时到期时刻 ms
+    void       *wait_obj;       // 正在等待的信号量
+    uint32_t   *stack_base;
+    uint32_t    stack_words;
+} Kernel_Thread_t;
+
+typedef struct {
+    volatile uint16_t count;
+    uint16_t          max;
+} Kernel_Sem_t;
+
+typedef struct {
+    uint32_t     *buffer;
+    uint16_t      size;
+    uint16_t      head;
+    uint16_t      tail;
+    uint16_t      used;         // 已存放的消息数
+    Kernel_Sem_t  items;        // 队列中消息数
+} Kernel_Queue_t;
+
+// 线程
+void Kernel_Init(void);
+void Kernel_CreateThread(Kernel_Thread_t *thread, const char *name, Kernel_Entry_t entry,
+                         uint8_t priority, uint64_t *stack, uint32_t stack_bytes);
+void Kernel_Start(void);
+void Kernel_Tick(void);
+void Kernel_Delay(uint32_t ms);
+void Kernel_DelayUntil(uint32_t *wake, uint32_t period);
+void Kernel_SleepUntil(uint32_t deadline);
+void Kernel_Lock(void);
+void Kernel_Unlock(void);
+Kernel_Thread_t *Kernel_Current(void);
+
+// 信号量（Post 可在中断中调用）
+void    Kernel_SemInit(Kernel_Sem_t *sem, uint16_t initial, uint16_t max);
+uint8_t Kernel_SemWait(Kernel_Sem_t *sem, uint32_t timeout_ms);
+void    Kernel_SemPost(Kernel_Sem_t *sem);
+
+// 消息队列（Put 可在中断中调用，不阻塞）
+void    Kernel_QueueInit(Kernel_Queue_t *q, uint32_t *buffer, uint16_t size);
+uint8_t Kernel_QueuePut(Kernel_Queue_t *q, uint32_t msg);
+uint8_t Kernel_QueueGet(Kernel_Queue_t *q, uint32_t *msg, uint32_t timeout_ms);
+
+// 统计
+uint32_t Kernel_GetSwitchCycles(void);      // 最近一次 PendSV 切换耗时（CPU 周期）
+uint32_t Kernel_GetMaxSwitchCycles(void);
+uint32_t Kernel_GetStackFree(const Kernel_Thread_t *thread);   // 从未使用过的栈字节数
+const Kernel_Thread_t *Kernel_GetThread(uint8_t index);
+
+#endif // __KERNEL_H
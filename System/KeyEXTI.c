@@ -2,6 +2,8 @@
   文件：KeyEXTI.c
   功能：优化的基于定时器中断的按键处理模块（支持短按、长按、连续按）
   优化：减少消抖时间，提高响应速度，增加边沿检测
+        TIM3 中断只做消抖和计时，按下/释放/长按/连发作为事件投递到 Event 队列；
+        界面线程用 KeyEXTI_HandleEvent 处理转发来的事件，各查询函数只读界面侧状态
 ==============================================================================*/
 #include "stm32f10x.h"
 #include "KeyEXTI.h"
@@ -9,6 +11,11 @@
 #include "LightControl.h"
 #include "OLED.h"
 #include "Delay.h"
+#include "Timebase.h"
+#include "Event.h"
+#include "Prof.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
 
 // 优化后的消抖和长按参数
 #define DEBOUNCE_TIME_MS    8     // 8ms消抖时间（减少延迟）
@@ -30,7 +37,9 @@
 #define KEY3_PRES   3
 #define KEY4_PRES   4
 
-// 按键状态结构体
+#define SHORT_QUEUE_SIZE    8     // 界面侧缓存的短按次数，多个按键同时短按不丢失
+
+// 按键状态结构体（仅 TIM3 中断访问）
 typedef struct {
     uint8_t stable_state;        // 消抖后稳定状态：1未按，0按下
     uint8_t last_raw_state;      // 上次原始采样状态
@@ -38,23 +47,33 @@ typedef struct {
     uint8_t debounce_counter;    // 消抖计数器（减少位数提高效率）
     uint8_t pressed_flag;        // 按键按下标志
     uint16_t press_time_counter; // 按键按下持续时间计数（ms）
-    uint8_t short_press_flag;    // 短按标志
-    uint8_t long_press_flag;     // 长按标志
-    uint8_t long_press_handled;  // 长按是否已处理标志
-    uint8_t repeat_flag;         // 连续触发标志
+    uint8_t long_press_flag;     // 本次按下已达到长按时间
     uint8_t repeat_counter;      // 连续触发计数器（减少位数）
     uint8_t edge_detected;       // 边沿检测标志（新增）
 } KeyState_t;
 
+// 按键事件处理后的状态（仅界面线程访问）
+typedef struct {
+    uint8_t  pressed;            // 是否按下
+    uint8_t  long_seen;          // 本次按下已出现长按，释放时不再算短按
+    uint8_t  long_pending;       // 长按未被读取
+    uint8_t  repeat_pending;     // 未读取的连发次数
+    uint32_t down_time;          // 按下时刻（ms）
+} KeyView_t;
+
 // 4个按键的状态
-static volatile KeyState_t keys[4] = {
-    {1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0},  // KEY1
-    {1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0},  // KEY2
-    {1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0},  // KEY3
-    {1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0}   // KEY4
+static KeyState_t keys[4] = {
+    {1, 1, 1, 0, 0, 0, 0, 0, 0},  // KEY1
+    {1, 1, 1, 0, 0, 0, 0, 0, 0},  // KEY2
+    {1, 1, 1, 0, 0, 0, 0, 0, 0},  // KEY3
+    {1, 1, 1, 0, 0, 0, 0, 0, 0}   // KEY4
 };
 
-static volatile uint32_t sys_tick_counter = 0;    // 系统时钟计数器（ms）
+static KeyView_t views[4];
+static uint8_t short_queue[SHORT_QUEUE_SIZE];   // 短按按键号，按发生顺序
+static uint8_t short_head = 0;
+static uint8_t short_count = 0;
+
 
 // 按键引脚数组
 static const uint16_t key_pins[4] = {KEY1_PIN, KEY2_PIN, KEY3_PIN, KEY4_PIN};
@@ -97,10 +116,10 @@ void KeyEXTI_TimerInit(void)
     TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
     TIM_TimeBaseInit(TIM3, &TIM_TimeBaseStructure);
     
-    // 配置中断 - 提高优先级以确保及时响应
+    // 配置中断（优先级见 IrqPrio.h）
     NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
-    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;  // 最高优先级
-    NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = IRQ_PRIO_KEY_SCAN;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority = IRQ_SUBPRIO_DEFAULT;
     NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
     NVIC_Init(&NVIC_InitStructure);
     
@@ -111,13 +130,37 @@ void KeyEXTI_TimerInit(void)
     TIM_Cmd(TIM3, ENABLE);
 }
 
+/**
+  * @brief  消抖后的按下/释放：投递事件并重置计时
+  */
+static void KeyEXTI_OnPress(uint8_t key_idx)
+{
+    KeyState_t* key = &keys[key_idx];
+    key->pressed_flag = 1;
+    key->press_time_counter = 0;
+    key->long_press_flag = 0;
+    key->repeat_counter = 0;
+    Event_Post(EVENT_KEY_DOWN, key_idx + 1, 0);
+}
+
+static void KeyEXTI_OnRelease(uint8_t key_idx)
+{
+    KeyState_t* key = &keys[key_idx];
+    if (key->pressed_flag) {
+        Event_Post(EVENT_KEY_UP, key_idx + 1, key->press_time_counter);
+    }
+    key->pressed_flag = 0;
+    key->press_time_counter = 0;
+    key->repeat_counter = 0;
+}
+
 /**
   * @brief  处理单个按键的状态机（优化版）
   * @param  key_idx: 按键索引(0-3)
   */
 static void KeyEXTI_ProcessKey(uint8_t key_idx)
 {
-    volatile KeyState_t* key = &keys[key_idx];
+    KeyState_t* key = &keys[key_idx];
     key->raw_state = GPIO_ReadInputDataBit(KEY_GPIO, key_pins[key_idx]);  // 读取当前电平
     
     // 边沿检测（立即响应按键变化）
@@ -135,26 +178,8 @@ static void KeyEXTI_ProcessKey(uint8_t key_idx)
             if (key->debounce_counter == DEBOUNCE_TIME_MS) {
                 if (key->stable_state != key->raw_state) {
                     key->stable_state = key->raw_state;
-                    
-                    if (key->raw_state == 0) {
-                        // 按键按下事件
-                        key->pressed_flag = 1;
-                        key->press_time_counter = 0;
-                        key->long_press_flag = 0;
-                        key->long_press_handled = 0;
-                        key->repeat_flag = 0;
-                        key->repeat_counter = 0;
-                    } else {
-                        // 按键释放事件
-                        if (key->pressed_flag && !key->long_press_flag) {
-                            // 短按事件
-                            key->short_press_flag = 1;
-                        }
-                        key->pressed_flag = 0;
-                        key->press_time_counter = 0;
-                        key->repeat_flag = 0;
-                        key->repeat_counter = 0;
-                    }
+                    if (key->raw_state == 0) KeyEXTI_OnPress(key_idx);
+                    else                     KeyEXTI_OnRelease(key_idx);
                 }
             }
         }
@@ -165,25 +190,8 @@ static void KeyEXTI_ProcessKey(uint8_t key_idx)
         if (key->raw_state == key->last_raw_state && key->stable_state != key->raw_state) {
             key->stable_state = key->raw_state;
             key->debounce_counter = DEBOUNCE_TIME_MS;  // 直接设为消抖完成
-            
-            if (key->raw_state == 0) {
-                // 按键按下事件（快速响应）
-                key->pressed_flag = 1;
-                key->press_time_counter = 0;
-                key->long_press_flag = 0;
-                key->long_press_handled = 0;
-                key->repeat_flag = 0;
-                key->repeat_counter = 0;
-            } else {
-                // 按键释放事件（快速响应）
-                if (key->pressed_flag && !key->long_press_flag) {
-                    key->short_press_flag = 1;
-                }
-                key->pressed_flag = 0;
-                key->press_time_counter = 0;
-                key->repeat_flag = 0;
-                key->repeat_counter = 0;
-            }
+            if (key->raw_state == 0) KeyEXTI_OnPress(key_idx);
+            else                     KeyEXTI_OnRelease(key_idx);
         }
         key->edge_detected = 0;
     }
@@ -197,7 +205,7 @@ static void KeyEXTI_ProcessKey(uint8_t key_idx)
         // 长按检测
         if (!key->long_press_flag && key->press_time_counter >= LONG_PRESS_TIME_MS) {
             key->long_press_flag = 1;
-            key->long_press_handled = 0;
+            Event_Post(EVENT_KEY_LONG, key_idx + 1, key->press_time_counter);
         }
         
         // 连续触发检测（用于配置模式）
@@ -205,25 +213,61 @@ static void KeyEXTI_ProcessKey(uint8_t key_idx)
             key->repeat_counter++;
             if (key->repeat_counter >= REPEAT_INTERVAL_MS) {
                 key->repeat_counter = 0;
-                key->repeat_flag = 1;
+                Event_Post(EVENT_KEY_REPEAT, key_idx + 1, key->press_time_counter);
             }
         }
     }
 }
 
+/**
+  * @brief  处理一个按键事件，更新界面侧状态（界面线程调用）
+  * @param  type: EVENT_KEY_DOWN/UP/LONG/REPEAT
+  * @param  key_num: 按键编号(1-4)
+  */
+void KeyEXTI_HandleEvent(uint8_t type, uint8_t key_num)
+{
+    if (key_num < 1 || key_num > 4) return;
+
+    KeyView_t* view = &views[key_num - 1];
+    switch (type) {
+        case EVENT_KEY_DOWN:
+            view->pressed = 1;
+            view->long_seen = 0;
+            view->long_pending = 0;
+            view->repeat_pending = 0;
+            view->down_time = Time_Ms();
+            break;
+        case EVENT_KEY_UP:
+            // 未出现长按的释放为短按；缓存满时丢弃最新的一次
+            if (!view->long_seen && short_count < SHORT_QUEUE_SIZE) {
+                short_queue[(short_head + short_count) % SHORT_QUEUE_SIZE] = key_num;
+                short_count++;
+            }
+            view->pressed = 0;
+            view->repeat_pending = 0;
+            break;
+        case EVENT_KEY_LONG:
+            view->long_seen = 1;
+            view->long_pending = 1;
+            break;
+        case EVENT_KEY_REPEAT:
+            if (view->repeat_pending < 255) view->repeat_pending++;
+            break;
+    }
+}
+
 /**
   * @brief  获取按键事件（类似原Key_GetNum()）
   * @retval 按键编号 (1-4) 或 KEY_NONE
   */
 uint8_t KeyEXTI_GetKey(void)
 {
-    for (uint8_t i = 0; i < 4; i++) {
-        if (keys[i].short_press_flag) {
-            keys[i].short_press_flag = 0;
-            return i + 1;
-        }
-    }
-    return KEY_NONE;
+    uint8_t key;
+    if (short_count == 0) return KEY_NONE;
+    key = short_queue[short_head];
+    short_head = (short_head + 1) % SHORT_QUEUE_SIZE;
+    short_count--;
+    return key;
 }
 
 /**
@@ -234,7 +278,7 @@ uint8_t KeyEXTI_GetKey(void)
 uint8_t KeyEXTI_GetKeyState(uint8_t key_num)
 {
     if (key_num < 1 || key_num > 4) return 0;
-    return keys[key_num - 1].pressed_flag;
+    return views[key_num - 1].pressed;
 }
 
 /**
@@ -246,9 +290,9 @@ uint8_t KeyEXTI_GetLongPress(uint8_t key_num)
 {
     if (key_num < 1 || key_num > 4) return 0;
     
-    volatile KeyState_t* key = &keys[key_num - 1];
-    if (key->long_press_flag && !key->long_press_handled) {
-        key->long_press_handled = 1;
+    KeyView_t* view = &views[key_num - 1];
+    if (view->long_pending) {
+        view->long_pending = 0;
         return 1;
     }
     return 0;
@@ -263,9 +307,9 @@ uint8_t KeyEXTI_GetRepeat(uint8_t key_num)
 {
     if (key_num < 1 || key_num > 4) return 0;
     
-    volatile KeyState_t* key = &keys[key_num - 1];
-    if (key->repeat_flag) {
-        key->repeat_flag = 0;
+    KeyView_t* view = &views[key_num - 1];
+    if (view->repeat_pending) {
+        view->repeat_pending--;
         return 1;
     }
     return 0;
@@ -279,7 +323,8 @@ uint8_t KeyEXTI_GetRepeat(uint8_t key_num)
 uint16_t KeyEXTI_GetPressTime(uint8_t key_num)
 {
     if (key_num < 1 || key_num > 4) return 0;
-    return keys[key_num - 1].press_time_counter;
+    if (!views[key_num - 1].pressed) return 0;
+    return (uint16_t)(Time_Ms() - views[key_num - 1].down_time);
 }
 
 /**
@@ -290,20 +335,28 @@ void KeyEXTI_ResetKey(uint8_t key_num)
 {
     if (key_num < 1 || key_num > 4) return;
     
-    volatile KeyState_t* key = &keys[key_num - 1];
-    key->short_press_flag = 0;
-    key->long_press_flag = 0;
-    key->long_press_handled = 0;
-    key->repeat_flag = 0;
-    key->edge_detected = 0;
+    KeyView_t* view = &views[key_num - 1];
+    view->long_pending = 0;
+    view->repeat_pending = 0;
+
+    // 移除该键缓存的短按
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < short_count; i++) {
+        uint8_t k = short_queue[(short_head + i) % SHORT_QUEUE_SIZE];
+        if (k != key_num) {
+            short_queue[(short_head + kept) % SHORT_QUEUE_SIZE] = k;
+            kept++;
+        }
+    }
+    short_count = kept;
 }
 
 /**
-  * @brief  获取系统时钟计数值（ms）
+  * @brief  兼容旧接口 - 系统毫秒计数，由 Timebase 的 SysTick 提供
   */
 uint32_t GetTick(void)
 {
-    return sys_tick_counter;
+    return Time_Ms();
 }
 
 /**
@@ -343,15 +396,17 @@ void KeyEXTI_ResetKey4LongPressFlag(void)
   */
 void TIM3_IRQHandler(void)
 {
+    // 更新事件时计数器归零，此时的计数值（1us/计数）即进入延迟
+    ISR_ENTER(ISR_TIM3, TIM_GetCounter(TIM3) * Time_CyclesPerUs());
+    PROF_BEGIN(PROF_TIM3_IRQ);
     if(TIM_GetITStatus(TIM3, TIM_IT_Update) != RESET) {
         TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
         
-        // 系统时钟计数
-        sys_tick_counter++;
-        
         // 处理所有按键 - 优化为内联处理提高效率
         for (uint8_t i = 0; i < 4; i++) {
             KeyEXTI_ProcessKey(i);
         }
     }
+    PROF_END(PROF_TIM3_IRQ);
+    ISR_EXIT(ISR_TIM3);
 }
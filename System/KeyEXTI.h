@@ -25,6 +25,7 @@ uint8_t KeyEXTI_GetLongPress(uint8_t key_num); // ??????
 uint8_t KeyEXTI_GetRepeat(uint8_t key_num);    // ????????
 uint16_t KeyEXTI_GetPressTime(uint8_t key_num); // ??????
 void KeyEXTI_ResetKey(uint8_t key_num);         // ??????
+void KeyEXTI_HandleEvent(uint8_t type, uint8_t key_num); // תİ¼̣߳
 
 // ????
 uint32_t GetTick(void);                     // ??????(ms)
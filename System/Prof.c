@@ -0,0 +1,119 @@
+/*==============================================================================
+  文件：Prof.c
+  功能：DWT 周期计数分析区段的统计与输出（PROF_ENABLE=0 时整个文件为空）
+==============================================================================*/
+#include "Prof.h"
+
+#if PROF_ENABLE
+
+#include "Format.h"
+
+// 清零/复制时关中断，主机编译可定义为空
+#ifndef PROF_CRITICAL_ENTER
+#include "stm32f10x.h"
+#define PROF_CRITICAL_ENTER()   uint32_t prof_primask = __get_PRIMASK(); __disable_irq()
+#define PROF_CRITICAL_EXIT()    __set_PRIMASK(prof_primask)
+#endif
+
+static const char *zone_names[PROF_ZONE_COUNT] = {
+    "LightUpd", "UpdDisp", "OLEDChar", "LDRLux",
+    "EchoCap", "DHT11", "TIM3IRQ", "EXTI9_5",
+};
+
+static Prof_Stats_t zones[PROF_ZONE_COUNT];
+static uint64_t reset_cycles;           // 上次清零时刻，用于计算各区段占比
+
+/**
+  * @brief  记录一次区段耗时（PROF_END 调用，中断中也可用）
+  */
+void Prof_Record(Prof_Zone_t id, uint32_t cycles)
+{
+    Prof_Stats_t *z = &zones[id];
+    if (z->calls == 0 || cycles < z->min) z->min = cycles;
+    if (cycles > z->max) z->max = cycles;
+    z->total += cycles;
+    z->calls++;
+}
+
+/**
+  * @brief  清零全部区段（关中断，避免与中断中的 Prof_Record 交错留下半更新的区段）
+  */
+void Prof_Reset(void)
+{
+    PROF_CRITICAL_ENTER();
+    for (uint8_t i = 0; i < PROF_ZONE_COUNT; i++) {
+        zones[i].calls = 0;
+        zones[i].total = 0;
+        zones[i].min = 0;
+        zones[i].max = 0;
+    }
+    reset_cycles = PROF_CYCLES64();
+    PROF_CRITICAL_EXIT();
+}
+
+/**
+  * @brief  关中断复制全部区段与统计区间，可同时清零（下一区间从此刻开始）
+  */
+void Prof_Snapshot(Prof_Snapshot_t *snap, uint8_t reset)
+{
+    uint64_t now;
+
+    PROF_CRITICAL_ENTER();
+    now = PROF_CYCLES64();
+    for (uint8_t i = 0; i < PROF_ZONE_COUNT; i++) {
+        snap->zones[i] = zones[i];
+        if (reset) {
+            zones[i].calls = 0;
+            zones[i].total = 0;
+            zones[i].min = 0;
+            zones[i].max = 0;
+        }
+    }
+    snap->elapsed = now - reset_cycles;
+    if (reset) reset_cycles = now;
+    PROF_CRITICAL_EXIT();
+}
+
+const Prof_Stats_t *Prof_GetZone(Prof_Zone_t id)
+{
+    return &zones[id];
+}
+
+const char *Prof_GetName(Prof_Zone_t id)
+{
+    return zone_names[id];
+}
+
+/**
+  * @brief  格式化统计表的一行：第 0 行为表头，第 1~PROF_ZONE_COUNT 行依次为各区段
+  *         名称 调用次数 平均/最小/最大周期 占统计区间的千分比
+  * @param  line: 至少 PROF_LINE_SIZE 字节
+  * @retval 1 已写入，0 行号超出
+  */
+uint8_t Prof_FormatLine(const Prof_Snapshot_t *snap, uint8_t row, char *line)
+{
+    const Prof_Stats_t *z;
+    uint32_t avg, permille;
+    uint8_t n;
+
+    if (row >= PROF_TABLE_LINES) return 0;
+    if (row == 0) {
+        Format_Str(line, "zone        calls      avg      min      max  permil");
+        return 1;
+    }
+
+    z = &snap->zones[row - 1];
+    avg = z->calls ? (uint32_t)(z->total / z->calls) : 0;
+    permille = snap->elapsed ? (uint32_t)(z->total * 1000 / snap->elapsed) : 0;
+
+    n = Format_Str(line, zone_names[row - 1]);
+    while (n < 8) line[n++] = ' ';
+    n += Format_UInt(line + n, z->calls, 9);
+    n += Format_UInt(line + n, avg, 9);
+    n += Format_UInt(line + n, z->min, 9);
+    n += Format_UInt(line + n, z->max, 9);
+    Format_UInt(line + n, permille, 8);
+    return 1;
+}
+
+#endif // PROF_ENABLE
@@ -0,0 +1,76 @@
+/*==============================================================================
+  文件：Prof.h
+  功能：DWT 周期计数分析区段
+        PROF_BEGIN(id) / PROF_END(id) 成对放在同一作用域内，统计每个区段的调用次数、
+        总周期、最小/最大周期。计时包含期间被中断或高优先级线程抢占的时间。
+        默认关闭（PROF_ENABLE=0），宏展开为空，不占代码和内存；
+        在工程 C/C++ Define 中加 PROF_ENABLE=1 开启
+        主机编译：gcc -DPROF_ENABLE=1 -D'PROF_CYCLES()=host_cycles()'
+                      -D'PROF_CYCLES64()=host_cycles()' -D'PROF_CRITICAL_ENTER()='
+                      -D'PROF_CRITICAL_EXIT()=' ...
+==============================================================================*/
+#ifndef __PROF_H
+#define __PROF_H
+
+#include <stdint.h>
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE     0
+#endif
+
+// 区段编号，新增区段时同步 Prof.c 中的名称表
+typedef enum {
+    PROF_LIGHT_UPDATE = 0,      // LightControl_Update
+    PROF_UPDATE_DISPLAY,        // Update_Display
+    PROF_OLED_CHAR,             // OLED_ShowChar
+    PROF_LDR_LUX,               // LDR_LuxData
+    PROF_ULTRASONIC,            // TIM1_CC_IRQHandler（超声回波捕获）
+    PROF_DHT11,                 // EXTI15_10_IRQHandler（DHT11 位解码）
+    PROF_TIM3_IRQ,              // TIM3_IRQHandler（按键扫描）
+    PROF_EXTI9_5_IRQ,           // EXTI9_5_IRQHandler（码盘）
+    PROF_ZONE_COUNT
+} Prof_Zone_t;
+
+typedef struct {
+    uint32_t calls;
+    uint64_t total;             // 总周期
+    uint32_t min;
+    uint32_t max;
+} Prof_Stats_t;
+
+// 某一时刻全部区段的副本，供分多次输出时保持整张表一致
+typedef struct {
+    Prof_Stats_t zones[PROF_ZONE_COUNT];
+    uint64_t     elapsed;       // 统计区间的周期数（自上次清零）
+} Prof_Snapshot_t;
+
+#define PROF_TABLE_LINES    (PROF_ZONE_COUNT + 1)   // 表头 + 每区段一行
+#define PROF_LINE_SIZE      64                      // Prof_FormatLine 的缓冲区大小
+
+#if PROF_ENABLE
+
+#ifndef PROF_CYCLES
+#include "Timebase.h"
+#define PROF_CYCLES()       DWT_CYCCNT
+#define PROF_CYCLES64()     Time_Cycles64()
+#endif
+
+#define PROF_BEGIN(id)      uint32_t prof_start_##id = PROF_CYCLES()
+#define PROF_END(id)        Prof_Record(id, PROF_CYCLES() - prof_start_##id)
+
+void Prof_Record(Prof_Zone_t id, uint32_t cycles);
+void Prof_Reset(void);
+const Prof_Stats_t *Prof_GetZone(Prof_Zone_t id);
+const char *Prof_GetName(Prof_Zone_t id);
+void Prof_Snapshot(Prof_Snapshot_t *snap, uint8_t reset);
+uint8_t Prof_FormatLine(const Prof_Snapshot_t *snap, uint8_t row, char *line);
+
+#else
+
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+#define Prof_Reset()
+
+#endif // PROF_ENABLE
+
+#endif // __PROF_H
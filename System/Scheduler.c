@@ -0,0 +1,193 @@
+/*==============================================================================
+  文件：Scheduler.c
+  功能：协作式多速率任务调度
+        每个任务按固定速率释放（next_release += period），与运行耗时无关；
+        错过整周期的释放直接跳过并计数，不会连续补跑。
+        无就绪任务时用 WFI 进入睡眠，统计睡眠时间占比。
+        睡眠时间只由睡眠的线程累加（单一写者），统计窗口只由运行 Sched_Run 的线程
+        结算，两个线程之间只传递一个 32 位累计值，无需加锁。
+==============================================================================*/
+#include "Scheduler.h"
+#include "Trace.h"
+
+// 运行耗时计数源，默认使用 DWT 周期计数；主机测试时定义为 0 或虚拟计数
+#ifndef SCHED_CYCLES
+#include "Timebase.h"
+#define SCHED_CYCLES()      Time_Cycles()
+#endif
+
+// 睡眠原语，返回实际睡眠的周期数；主机测试时替换为推进虚拟时间的函数
+#ifndef SCHED_SLEEP
+#include "stm32f10x.h"
+#define SCHED_SLEEP()       Sched_WaitForInterrupt()
+
+/**
+  * @brief  关中断后 WFI（Sleep 模式）：挂起的中断唤醒 CPU，但开中断后才进入服务函数
+  * @note   起止时刻都在关中断期间读取，唤醒中断的服务时间以及随后 PendSV 切换到的
+  *         更高优先级线程的运行时间都不计入睡眠
+  * @retval 睡眠周期数
+  */
+static uint32_t Sched_WaitForInterrupt(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t start, end;
+
+    __disable_irq();
+    start = SCHED_CYCLES();
+    __WFI();
+    end = SCHED_CYCLES();
+    __set_PRIMASK(primask);
+    return end - start;
+}
+#endif
+
+// 睡眠占比统计窗口（CPU 周期，默认 1s @72MHz）
+#ifndef SCHED_WINDOW_CYCLES
+#define SCHED_WINDOW_CYCLES 72000000UL
+#endif
+
+static Sched_Task_t *sched_tasks = 0;
+static uint8_t       sched_count = 0;
+
+static volatile uint32_t sleep_total = 0;  // 累计睡眠周期（回绕），只由 Sched_Sleep 写
+static uint32_t window_start = 0;       // 当前窗口起点，以下三项只由 Sched_Run 的线程读写
+static uint32_t window_sleep = 0;       // 窗口起点时的 sleep_total
+static uint16_t sleep_permille = 0;     // 上一个完整窗口的睡眠占比（‰）
+
+/**
+  * @brief  窗口到期时结算睡眠占比（只在 Sched_Run 中调用）
+  */
+static void Sched_UpdateWindow(uint32_t now_cycles)
+{
+    uint32_t elapsed = now_cycles - window_start;
+    uint32_t total, slept;
+    if (elapsed < SCHED_WINDOW_CYCLES) return;
+
+    total = sleep_total;
+    slept = total - window_sleep;
+    if (slept > elapsed) slept = elapsed;   // 跨越窗口起点的一次睡眠整体计入本窗口
+    sleep_permille = (uint16_t)((uint64_t)slept * 1000 / elapsed);
+    window_sleep = total;
+    window_start = now_cycles;
+}
+
+/**
+  * @brief  调度器初始化
+  * @param  tasks: 任务表
+  * @param  count: 任务数
+  * @param  now: 当前时刻 ms，各任务首次释放时刻为 now + phase
+  */
+void Sched_Init(Sched_Task_t *tasks, uint8_t count, uint32_t now)
+{
+    sched_tasks = tasks;
+    sched_count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        tasks[i].next_release = now + tasks[i].phase;
+    }
+    Sched_ResetStats();
+    window_start = SCHED_CYCLES();
+    window_sleep = sleep_total;
+}
+
+/**
+  * @brief  运行一个就绪任务（优先级最高者，同优先级按表中顺序）
+  * @param  now: 当前时刻 ms
+  * @retval 1 运行了任务，0 没有就绪任务（可进入空闲处理）
+  */
+uint8_t Sched_Run(uint32_t now)
+{
+    Sched_Task_t *task = 0;
+
+    for (uint8_t i = 0; i < sched_count; i++) {
+        Sched_Task_t *t = &sched_tasks[i];
+        if ((int32_t)(now - t->next_release) < 0) continue;
+        if (task == 0 || t->priority < task->priority) {
+            task = t;
+        }
+    }
+    if (task == 0) return 0;
+
+    uint32_t latency = now - task->next_release;
+    if (latency > task->max_latency) task->max_latency = latency;
+    if (latency > task->deadline) task->misses++;
+
+    // 固定速率：下一次释放按周期累加；已错过的整周期跳过
+    task->next_release += task->period;
+    while ((int32_t)(now - task->next_release) >= 0) {
+        task->next_release += task->period;
+        task->skips++;
+    }
+
+    uint32_t start = SCHED_CYCLES();
+    TRACE_BEGIN(TRACE_TASK, task - sched_tasks);
+    task->func();
+    TRACE_END(TRACE_TASK, task - sched_tasks);
+    uint32_t cycles = SCHED_CYCLES() - start;
+
+    task->runs++;
+    task->last_cycles = cycles;
+    if (cycles > task->max_cycles) task->max_cycles = cycles;
+    Sched_UpdateWindow(start + cycles);
+    return 1;
+}
+
+/**
+  * @brief  睡眠直到下一个中断（SysTick 每 1ms 一次，或按键/码盘/DMA 等中断）
+  * @note   调用者先确认没有就绪任务和待处理工作（线程内核下为空闲线程）；
+  *         只累加睡眠时间，占比由 Sched_Run 所在线程结算
+  */
+void Sched_Sleep(void)
+{
+    sleep_total += SCHED_SLEEP();
+}
+
+/**
+  * @brief  上一个统计窗口（约 1s）内睡眠时间占比，单位 ‰
+  */
+uint16_t Sched_GetSleepPermille(void)
+{
+    return sleep_permille;
+}
+
+/**
+  * @brief  最近的下一次释放时刻（空闲处理可运行到此刻）
+  */
+uint32_t Sched_NextRelease(void)
+{
+    uint32_t next = sched_tasks[0].next_release;
+    for (uint8_t i = 1; i < sched_count; i++) {
+        if ((int32_t)(sched_tasks[i].next_release - next) < 0) {
+            next = sched_tasks[i].next_release;
+        }
+    }
+    return next;
+}
+
+/**
+  * @brief  读取任务统计
+  */
+const Sched_Task_t *Sched_GetTask(uint8_t index)
+{
+    if (index >= sched_count) return 0;
+    return &sched_tasks[index];
+}
+
+uint8_t Sched_GetTaskCount(void)
+{
+    return sched_count;
+}
+
+/**
+  * @brief  清零运行统计
+  */
+void Sched_ResetStats(void)
+{
+    for (uint8_t i = 0; i < sched_count; i++) {
+        sched_tasks[i].runs = 0;
+        sched_tasks[i].misses = 0;
+        sched_tasks[i].skips = 0;
+        sched_tasks[i].max_latency = 0;
+        sched_tasks[i].last_cycles = 0;
+        sched_tasks[i].max_cycles = 0;
+    }
+}
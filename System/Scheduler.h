@@ -0,0 +1,47 @@
+/*==============================================================================
+  文件：Scheduler.h
+  功能：协作式多速率任务调度（静态任务表，任务运行至完成）
+        时间由调用者传入，主机上可用虚拟时间测试：定义 SCHED_CYCLES()（周期计数）和
+        SCHED_SLEEP()（推进虚拟时间并返回睡眠周期数）后编译 Scheduler.c 即不依赖芯片，
+        见 Tools/test_scheduler.c
+==============================================================================*/
+#ifndef __SCHEDULER_H
+#define __SCHEDULER_H
+
+#include <stdint.h>
+
+typedef void (*Sched_TaskFunc_t)(void);
+
+typedef struct {
+    // 配置
+    const char      *name;
+    Sched_TaskFunc_t func;
+    uint16_t period;        // 周期 ms
+    uint16_t phase;         // 首次释放相对启动时刻的偏移 ms，用于错开各任务
+    uint8_t  priority;      // 优先级，0 最高；同时就绪时先运行高优先级
+    uint16_t deadline;      // 相对释放时刻的截止时间 ms，开始运行晚于此视为超时
+
+    // 运行状态与统计
+    uint32_t next_release;  // 下一次释放时刻 ms
+    uint32_t runs;          // 运行次数
+    uint32_t misses;        // 截止时间超时次数
+    uint32_t skips;         // 因严重延迟跳过的释放次数
+    uint32_t max_latency;   // 最大释放延迟 ms
+    uint32_t last_cycles;   // 最近一次运行耗时（CPU 周期）
+    uint32_t max_cycles;    // 最长运行耗时（CPU 周期）
+} Sched_Task_t;
+
+// 任务表初始化项：名称、函数、周期、相位、优先级、截止时间
+#define SCHED_TASK(name, func, period, phase, priority, deadline) \
+    {name, func, period, phase, priority, deadline, 0, 0, 0, 0, 0, 0, 0}
+
+void Sched_Init(Sched_Task_t *tasks, uint8_t count, uint32_t now);
+uint8_t Sched_Run(uint32_t now);
+uint32_t Sched_NextRelease(void);
+void Sched_Sleep(void);
+uint16_t Sched_GetSleepPermille(void);
+const Sched_Task_t *Sched_GetTask(uint8_t index);
+uint8_t Sched_GetTaskCount(void);
+void Sched_ResetStats(void);
+
+#endif // __SCHEDULER_H
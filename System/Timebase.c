@@ -0,0 +1,124 @@
+/*==============================================================================
+  文件：Timebase.c
+  功能：DWT + SysTick 统一时基
+==============================================================================*/
+#include "stm32f10x.h"
+#include "system_stm32f10x.h"
+#include "Timebase.h"
+#include "IsrStat.h"
+
+static volatile uint32_t time_ms = 0;       // SysTick 毫秒计数
+static volatile uint32_t cycles_high = 0;   // DWT 回绕次数（64 位计数的高 32 位）
+static volatile uint32_t cycles_last = 0;   // 上次 SysTick 时的 DWT 值，用于检测回绕
+static uint32_t cycles_per_us = 72;
+static void    (*tick_hook)(void) = 0;    // 每 1ms 在 SysTick 中调用（内核节拍）
+
+/**
+  * @brief  时基初始化：开启 DWT 周期计数，SysTick 1ms 中断（最低优先级）
+  * @note   须在 SystemCoreClockUpdate() 之后调用
+  */
+void Time_Init(void)
+{
+    cycles_per_us = SystemCoreClock / 1000000;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
+    time_ms = 0;
+    cycles_high = 0;
+    cycles_last = 0;
+    SysTick_Config(SystemCoreClock / 1000);
+}
+
+/**
+  * @brief  SysTick 中断：毫秒计数，并在 DWT 回绕时进位
+  */
+void SysTick_Handler(void)
+{
+    // VAL 从 LOAD 倒计数，已走过的计数即进入延迟（周期）
+    ISR_ENTER(ISR_SYSTICK, SysTick->LOAD - SysTick->VAL);
+    uint32_t now = DWT_CYCCNT;
+    if (now < cycles_last) {
+        cycles_high++;
+    }
+    cycles_last = now;
+    time_ms++;
+
+    if (tick_hook) {
+        tick_hook();
+    }
+    ISR_EXIT(ISR_SYSTICK);
+}
+
+/**
+  * @brief  注册 1ms 节拍回调（在 SysTick 中断中执行，须简短）
+  */
+void Time_SetTickHook(void (*hook)(void))
+{
+    tick_hook = hook;
+}
+
+uint32_t Time_Cycles(void)
+{
+    return DWT_CYCCNT;
+}
+
+/**
+  * @brief  64 位周期计数（中断与主程序均可调用，无需关中断）
+  */
+uint64_t Time_Cycles64(void)
+{
+    uint32_t high, last, now;
+    do {
+        high = cycles_high;
+        last = cycles_last;
+        now = DWT_CYCCNT;
+    } while (high != cycles_high);
+
+    // 上次 SysTick 之后发生的回绕尚未进位
+    if (now < last) {
+        high++;
+    }
+    return ((uint64_t)high << 32) | now;
+}
+
+uint64_t Time_Us64(void)
+{
+    return Time_Cycles64() / cycles_per_us;
+}
+
+uint32_t Time_Us(void)
+{
+    return (uint32_t)Time_Us64();
+}
+
+uint32_t Time_Ms(void)
+{
+    return time_ms;
+}
+
+uint32_t Time_CyclesPerUs(void)
+{
+    return cycles_per_us;
+}
+
+uint32_t Time_DeadlineUs(uint32_t us)
+{
+    return Time_Us() + us;
+}
+
+uint8_t Time_ReachedUs(uint32_t deadline)
+{
+    return (int32_t)(Time_Us() - deadline) >= 0;
+}
+
+uint32_t Time_DeadlineMs(uint32_t ms)
+{
+    return time_ms + ms;
+}
+
+uint8_t Time_ReachedMs(uint32_t deadline)
+{
+    return (int32_t)(time_ms - deadline) >= 0;
+}
@@ -0,0 +1,32 @@
+/*==============================================================================
+  文件：Timebase.h
+  功能：统一时基
+        DWT 周期计数器提供亚微秒分辨率，SysTick 以 1ms 自由运行（不再被延时函数重编程），
+        在 SysTick 中断中扩展 DWT 的高 32 位，得到 64 位单调时间
+==============================================================================*/
+#ifndef __TIMEBASE_H
+#define __TIMEBASE_H
+
+#include <stdint.h>
+
+// DWT 寄存器（本工程 CMSIS 版本未提供 DWT 结构体）
+#define DWT_CTRL        (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT      (*(volatile uint32_t *)0xE0001004)
+#define DWT_CTRL_CYCCNTENA  0x00000001
+
+void     Time_Init(void);
+uint32_t Time_Cycles(void);             // 32 位周期计数，约 59.6s 回绕，用于短间隔测量
+uint64_t Time_Cycles64(void);           // 64 位周期计数
+uint64_t Time_Us64(void);               // 上电以来的微秒数（64 位，不回绕）
+uint32_t Time_Us(void);                 // 微秒低 32 位，约 71 分钟回绕，差值运算仍正确
+uint32_t Time_Ms(void);                 // 上电以来的毫秒数（SysTick 计数）
+uint32_t Time_CyclesPerUs(void);
+void     Time_SetTickHook(void (*hook)(void));
+
+// 截止时间：deadline = Time_DeadlineXx(间隔)，之后用 Time_ReachedXx(deadline) 判断是否到期
+uint32_t Time_DeadlineUs(uint32_t us);
+uint8_t  Time_ReachedUs(uint32_t deadline);
+uint32_t Time_DeadlineMs(uint32_t ms);
+uint8_t  Time_ReachedMs(uint32_t deadline);
+
+#endif // __TIMEBASE_H
@@ -0,0 +1,276 @@
+/*==============================================================================
+  文件：Trace.c
+  功能：二进制事件跟踪环形缓冲区与串口导出
+        head 为已写入的记录总数，由 LDREX/STREX 递增预留槽位，中断嵌套时重试，
+        因此线程与任意优先级的中断可同时记录；缓冲区满后覆盖最旧的记录。
+        时间戳在预留槽位之前读取，被中断打断时相邻记录的时间可能轻微乱序，
+        由主机转换脚本按时间重新排序
+==============================================================================*/
+#include "stm32f10x.h"
+#include "Trace.h"
+#include "Timebase.h"
+#include "Kernel.h"
+#include "OLED.h"
+#include "Prof.h"
+
+#if TRACE_ENABLE
+
+#define TRACE_MASK          (TRACE_SIZE - 1)
+
+// 导出串口与硬件 I2C OLED 共用 PB10/PB11
+#define TRACE_UART          (!OLED_USE_HW_I2C)
+#define TRACE_USART         USART3
+#define TRACE_BAUD          115200
+
+static volatile Trace_Record_t trace_buffer[TRACE_SIZE];
+static volatile uint32_t trace_head = 0;       // 已写入的记录总数
+static volatile uint8_t  trace_enabled = 0;
+
+/**
+  * @brief  当前执行上下文：中断、线程优先级或内核启动前的主程序
+  */
+static uint8_t Trace_Context(void)
+{
+    Kernel_Thread_t *thread;
+
+    if (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) return TRACE_CTX_ISR;
+    thread = Kernel_Current();
+    return thread ? thread->priority : TRACE_CTX_MAIN;
+}
+
+void Trace_Init(void)
+{
+#if TRACE_UART
+    GPIO_InitTypeDef GPIO_InitStructure;
+    USART_InitTypeDef USART_InitStructure;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_USART3, ENABLE);
+
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_10;          // TX
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AF_PP;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_11;          // RX
+    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_IN_FLOATING;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+    USART_InitStructure.USART_BaudRate = TRACE_BAUD;
+    USART_InitStructure.USART_WordLength = USART_WordLength_8b;
+    USART_InitStructure.USART_StopBits = USART_StopBits_1;
+    USART_InitStructure.USART_Parity = USART_Parity_No;
+    USART_InitStructure.USART_HardwareFlowControl = USART_HardwareFlowControl_None;
+    USART_InitStructure.USART_Mode = USART_Mode_Tx | USART_Mode_Rx;
+    USART_Init(TRACE_USART, &USART_InitStructure);
+    USART_Cmd(TRACE_USART, ENABLE);
+#endif
+    Trace_Clear();
+    trace_enabled = 1;
+}
+
+/**
+  * @brief  写入一条记录，可在任意线程或中断中调用
+  * @param  id: 阶段 | 事件号（一般通过 TRACE_BEGIN/TRACE_END/TRACE_MARK 调用）
+  */
+void Trace_Record(uint8_t id, uint16_t arg)
+{
+    uint32_t time, index;
+    volatile Trace_Record_t *r;
+
+    if (!trace_enabled) return;
+
+    time = DWT_CYCCNT;
+    do {
+        index = __LDREXW((uint32_t *)&trace_head);
+    } while (__STREXW(index + 1, (uint32_t *)&trace_head));
+
+    r = &trace_buffer[index & TRACE_MASK];
+    r->time = time;
+    r->id = id;
+    r->ctx = Trace_Context();
+    r->arg = arg;
+}
+
+/**
+  * @brief  暂停/恢复记录（导出前暂停，避免读取时被覆盖）
+  */
+void Trace_Enable(uint8_t enable)
+{
+    trace_enabled = enable;
+}
+
+/**
+  * @brief  按从旧到新的顺序复制缓冲区中的记录（须先暂停记录）
+  * @retval 复制的条数
+  */
+uint16_t Trace_Read(Trace_Record_t *out, uint16_t max)
+{
+    uint32_t head = trace_head;
+    uint32_t count = head < TRACE_SIZE ? head : TRACE_SIZE;
+    uint32_t start;
+
+    if (count > max) count = max;
+    start = head - count;
+    for (uint32_t i = 0; i < count; i++) {
+        volatile Trace_Record_t *r = &trace_buffer[(start + i) & TRACE_MASK];
+        out[i].time = r->time;
+        out[i].id = r->id;
+        out[i].ctx = r->ctx;
+        out[i].arg = r->arg;
+    }
+    return (uint16_t)count;
+}
+
+void Trace_Clear(void)
+{
+    trace_head = 0;
+}
+
+#if TRACE_UART
+
+// 分批导出的进度：下一条与结束时的记录序号
+static uint8_t  dump_active = 0;
+static uint32_t dump_next, dump_end;
+
+static void Trace_PutChar(char c)
+{
+    while (USART_GetFlagStatus(TRACE_USART, USART_FLAG_TXE) == RESET);
+    USART_SendData(TRACE_USART, (uint8_t)c);
+}
+
+static void Trace_PutString(const char *s)
+{
+    while (*s) Trace_PutChar(*s++);
+}
+
+static void Trace_PutHex(uint32_t value, uint8_t digits)
+{
+    while (digits--) {
+        Trace_PutChar("0123456789ABCDEF"[(value >> (digits * 4)) & 0xF]);
+    }
+}
+
+#if PROF_ENABLE
+// 分批输出的 Prof 统计表：收到 'p' 时复制并清零，之后每次 Trace_Poll 发送 TRACE_PROF_LINES 行
+static Prof_Snapshot_t prof_snap;
+static uint8_t prof_row = PROF_TABLE_LINES;     // 下一行，等于 PROF_TABLE_LINES 表示未在输出
+
+static void Trace_ProfStart(void)
+{
+    Prof_Snapshot(&prof_snap, 1);
+    prof_row = 0;
+}
+
+static void Trace_ProfStep(void)
+{
+    char line[PROF_LINE_SIZE];
+
+    for (uint8_t n = 0; n < TRACE_PROF_LINES && Prof_FormatLine(&prof_snap, prof_row, line); n++) {
+        Trace_PutString(line);
+        Trace_PutString("\r\n");
+        prof_row++;
+    }
+}
+#define TRACE_PROF_BUSY()   (prof_row < PROF_TABLE_LINES)
+#else
+#define TRACE_PROF_BUSY()   0
+#define Trace_ProfStart()
+#define Trace_ProfStep()
+#endif
+
+/**
+  * @brief  开始导出：暂停记录，发送表头；记录行由之后的 Trace_Poll 分批发送，
+  *         全部发送完后清空缓冲区并恢复记录
+  * @note   每次 Trace_Poll 只阻塞发送 TRACE_DUMP_LINES 行（约 8ms），界面线程 20ms
+  *         调用一次，512 条约 2.6s 发完；导出期间忽略新的串口命令
+  *         格式：
+  *           TRACE <每微秒周期数> <条数> <记录总数>
+  *           <time> <id> <ctx> <arg>      每条一行，十六进制
+  *           END
+  */
+void Trace_Dump(void)
+{
+    uint32_t head, count;
+
+    if (dump_active) return;
+    trace_enabled = 0;
+    head = trace_head;
+    count = head < TRACE_SIZE ? head : TRACE_SIZE;
+    dump_next = head - count;
+    dump_end = head;
+    dump_active = 1;
+
+    Trace_PutString("\r\nTRACE ");
+    Trace_PutHex(Time_CyclesPerUs(), 2);
+    Trace_PutChar(' ');
+    Trace_PutHex(count, 4);
+    Trace_PutChar(' ');
+    Trace_PutHex(head, 8);
+    Trace_PutString("\r\n");
+}
+
+/**
+  * @brief  发送至多 TRACE_DUMP_LINES 条记录，发完时结束导出
+  */
+static void Trace_DumpStep(void)
+{
+    for (uint8_t n = 0; n < TRACE_DUMP_LINES && dump_next != dump_end; n++, dump_next++) {
+        volatile Trace_Record_t *r = &trace_buffer[dump_next & TRACE_MASK];
+        Trace_PutHex(r->time, 8);
+        Trace_PutChar(' ');
+        Trace_PutHex(r->id, 2);
+        Trace_PutChar(' ');
+        Trace_PutHex(r->ctx, 2);
+        Trace_PutChar(' ');
+        Trace_PutHex(r->arg, 4);
+        Trace_PutString("\r\n");
+    }
+    if (dump_next == dump_end) {
+        Trace_PutString("END\r\n");
+        dump_active = 0;
+        trace_head = 0;
+        trace_enabled = 1;
+    }
+}
+
+/**
+  * @brief  查询串口命令（在 UI 线程中周期调用）
+  *         'd' 开始导出跟踪记录，之后每次调用继续发送一批；
+  *         'p' 复制并清零 Prof 区段统计（覆盖自上次 'p' 以来的区间），之后每次调用
+  *         发送 TRACE_PROF_LINES 行，PROF_ENABLE=0 时忽略
+  */
+void Trace_Poll(void)
+{
+    char c;
+
+    if (USART_GetFlagStatus(TRACE_USART, USART_FLAG_RXNE) == SET) {
+        c = (char)USART_ReceiveData(TRACE_USART);
+        if (dump_active || TRACE_PROF_BUSY()) {
+            // 输出期间丢弃命令
+        } else if (c == 'd' || c == 'D') {
+            Trace_Dump();
+            return;
+        } else if (c == 'p' || c == 'P') {
+            Trace_ProfStart();
+        }
+    }
+    if (dump_active) {
+        Trace_DumpStep();
+    } else if (TRACE_PROF_BUSY()) {
+        Trace_ProfStep();
+    }
+}
+
+#else
+
+void Trace_Dump(void)
+{
+}
+
+void Trace_Poll(void)
+{
+}
+
+#endif // TRACE_UART
+
+#endif // TRACE_ENABLE
@@ -0,0 +1,83 @@
+/*==============================================================================
+  文件：Trace.h
+  功能：二进制事件跟踪
+        每条记录 8 字节（时间戳、事件号、上下文、参数），写入 RAM 环形缓冲区，
+        满后覆盖最旧的记录。线程和中断中均可调用，不关中断。
+        TRACE_BEGIN/TRACE_END 在同一上下文中成对使用，表示一个区段；
+        TRACE_MARK 表示瞬时事件。
+        串口导出：USART3（PB10 TX / PB11 RX，115200 8N1），收到 'd' 后以十六进制文本
+        导出整个缓冲区（分多次 Trace_Poll 发送），主机用 Tools/trace2json.py 转成
+        Chrome/Perfetto JSON；
+        收到 'p' 分批输出 Prof 区段统计表（PROF_ENABLE=1 时）。
+        PB10/PB11 与硬件 I2C OLED 冲突，OLED_USE_HW_I2C=1 时只记录不导出。
+        默认开启；工程 C/C++ Define 中加 TRACE_ENABLE=0 可完全移除
+==============================================================================*/
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include <stdint.h>
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE        1
+#endif
+
+#ifndef TRACE_SIZE
+#define TRACE_SIZE          512         // 记录条数，必须为 2 的幂（4KB）
+#endif
+#define TRACE_DUMP_LINES    4           // 导出时每次 Trace_Poll 发送的记录数（约 8ms）
+#define TRACE_PROF_LINES    2           // 输出 Prof 统计表时每次发送的行数（约 9ms）
+
+// 事件号（低 6 位），新增事件时同步 Tools/trace2json.py 中的名称表
+typedef enum {
+    TRACE_ISR = 1,              // 中断，arg = IsrStat_Id_t（只记录 ISR_TRACE_MASK 中的中断）
+    TRACE_SWITCH,               // 线程切换（瞬时），arg = 切入线程优先级
+    TRACE_TASK,                 // 调度表任务，arg = 任务在表中的序号
+    TRACE_CONTROL,              // 控制周期
+    TRACE_LDR,                  // 光照采集，结束 arg = lux
+    TRACE_DHT11,                // 温湿度读取（瞬时），启动 arg = 0xFFFF，完成 arg = 状态
+    TRACE_ULTRASONIC,           // 超声样本（瞬时，捕获中断中），arg = 0.1cm
+    TRACE_FLASH,                // 参数写 Flash，结束 arg = 1 成功 / 0 失败
+    TRACE_OLED_FLUSH,           // OLED 刷新一片，开始 arg = 页号，结束 arg = 字节数
+    TRACE_ID_COUNT
+} Trace_Id_t;
+
+// 阶段（高 2 位）
+#define TRACE_PHASE_MARK    0x00
+#define TRACE_PHASE_BEGIN   0x40
+#define TRACE_PHASE_END     0x80
+
+#define TRACE_CTX_ISR       0xFF        // 中断上下文
+#define TRACE_CTX_MAIN      0xFE        // 内核启动前的主程序
+
+typedef struct {
+    uint32_t time;              // DWT 周期计数
+    uint8_t  id;                // 阶段 | 事件号
+    uint8_t  ctx;               // 线程优先级，或 TRACE_CTX_ISR / TRACE_CTX_MAIN
+    uint16_t arg;
+} Trace_Record_t;
+
+#if TRACE_ENABLE
+
+#define TRACE_BEGIN(id, arg)    Trace_Record(TRACE_PHASE_BEGIN | (id), (uint16_t)(arg))
+#define TRACE_END(id, arg)      Trace_Record(TRACE_PHASE_END | (id), (uint16_t)(arg))
+#define TRACE_MARK(id, arg)     Trace_Record(TRACE_PHASE_MARK | (id), (uint16_t)(arg))
+
+void     Trace_Init(void);
+void     Trace_Record(uint8_t id, uint16_t arg);
+void     Trace_Enable(uint8_t enable);
+uint16_t Trace_Read(Trace_Record_t *out, uint16_t max);
+void     Trace_Clear(void);
+void     Trace_Dump(void);
+void     Trace_Poll(void);
+
+#else
+
+#define TRACE_BEGIN(id, arg)
+#define TRACE_END(id, arg)
+#define TRACE_MARK(id, arg)
+#define Trace_Init()
+#define Trace_Poll()
+
+#endif // TRACE_ENABLE
+
+#endif // __TRACE_H
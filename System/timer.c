@@ -1,48 +0,0 @@
-#include "delay.h"
-#include "timer.h"
-#include "adcx.h"
-#include "led.h"
-#include "string.h"
-#include "ultrasonic.h"
-
-extern u16 msHcCount;
-void TIM4_Int_Init(u16 arr,u16 psc)
-{
-	TIM_TimeBaseInitTypeDef  TIM_TimeBaseStructure;
-	NVIC_InitTypeDef NVIC_InitStructure;
-
-	RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM4, ENABLE); 			//ʱʹ
-	
-	//ʱTIM4ʼ
-	TIM_TimeBaseStructure.TIM_Period = arr; 						//һ¼װԶװؼĴڵֵ	
-	TIM_TimeBaseStructure.TIM_Prescaler =psc; 						//ΪTIMxʱƵʳԤƵֵ
-	TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1; 		//ʱӷָ:TDTS = Tck_tim
-	TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;  	//TIMϼģʽ
-	TIM_TimeBaseInit(TIM4, &TIM_TimeBaseStructure); 				//ָĲʼTIMxʱλ
- 
-	TIM_ClearFlag(TIM4, TIM_FLAG_Update);  
-	TIM_ITConfig(TIM4,TIM_IT_Update,ENABLE ); 						//ʹָTIM4ж,ж
-	
-	//жȼNVIC
-	NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
-	
-	NVIC_InitStructure.NVIC_IRQChannel = TIM4_IRQn;  				//TIM4ж
-	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0; 		//ռȼ0
-	NVIC_InitStructure.NVIC_IRQChannelSubPriority = 0;  			//ȼ0
-	NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;					//IRQͨʹ
-	NVIC_Init(&NVIC_InitStructure); 								//ʼNVICĴ
-
-	TIM_Cmd(TIM4,DISABLE);     //TIM4					 
-}
-
-//ʱ4жϷ
-void TIM4_IRQHandler(void)   //TIM4ж		
-{
-   if (TIM_GetITStatus(TIM4, TIM_IT_Update) != RESET)  
-   {
-       TIM_ClearITPendingBit(TIM4, TIM_IT_Update  ); 
-       msHcCount++;
-   }
-}
-
-
@@ -1,9 +0,0 @@
-#ifndef _TIMER_H
-#define _TIMER_H
-#include "sys.h"
-
-
-void TIM4_Int_Init(u16 arr,u16 psc);		//ʱ4ʼ
-
-
-#endif
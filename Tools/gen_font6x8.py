@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+生成 Hardware/OLED_Font6x8.h：6x8 字模子集
+
+扫描固件源码中的字符串/字符常量，只输出实际用到的字形，另外总是包含
+运行时格式化数字需要的字符（空格、0~9、'-'、'.'）。
+未收录的字符在显示时回退为空格。
+
+用法（在工程根目录）：
+    python Tools/gen_font6x8.py            # 生成子集
+    python Tools/gen_font6x8.py --all      # 生成完整 ASCII 可见字符
+修改界面字符串后重新运行并提交生成的头文件。
+"""
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCAN_DIRS = ["User", "Hardware", "System"]
+OUTPUT = os.path.join(ROOT, "Hardware", "OLED_Font6x8.h")
+ALWAYS = " 0123456789-."
+
+# 5x7 点阵，每字节一列，低位在上；输出时左侧补一列空白成为 6x8
+FONT5X7 = {
+    ' ': (0x00, 0x00, 0x00, 0x00, 0x00), '!': (0x00, 0x00, 0x5F, 0x00, 0x00),
+    '"': (0x00, 0x07, 0x00, 0x07, 0x00), '#': (0x14, 0x7F, 0x14, 0x7F, 0x14),
+    '$': (0x24, 0x2A, 0x7F, 0x2A, 0x12), '%': (0x23, 0x13, 0x08, 0x64, 0x62),
+    '&': (0x36, 0x49, 0x55, 0x22, 0x50), "'": (0x00, 0x05, 0x03, 0x00, 0x00),
+    '(': (0x00, 0x1C, 0x22, 0x41, 0x00), ')': (0x00, 0x41, 0x22, 0x1C, 0x00),
+    '*': (0x14, 0x08, 0x3E, 0x08, 0x14), '+': (0x08, 0x08, 0x3E, 0x08, 0x08),
+    ',': (0x00, 0x50, 0x30, 0x00, 0x00), '-': (0x08, 0x08, 0x08, 0x08, 0x08),
+    '.': (0x00, 0x60, 0x60, 0x00, 0x00), '/': (0x20, 0x10, 0x08, 0x04, 0x02),
+    '0': (0x3E, 0x51, 0x49, 0x45, 0x3E), '1': (0x00, 0x42, 0x7F, 0x40, 0x00),
+    '2': (0x42, 0x61, 0x51, 0x49, 0x46), '3': (0x21, 0x41, 0x45, 0x4B, 0x31),
+    '4': (0x18, 0x14, 0x12, 0x7F, 0x10), '5': (0x27, 0x45, 0x45, 0x45, 0x39),
+    '6': (0x3C, 0x4A, 0x49, 0x49, 0x30), '7': (0x01, 0x71, 0x09, 0x05, 0x03),
+    '8': (0x36, 0x49, 0x49, 0x49, 0x36), '9': (0x06, 0x49, 0x49, 0x29, 0x1E),
+    ':': (0x00, 0x36, 0x36, 0x00, 0x00), ';': (0x00, 0x56, 0x36, 0x00, 0x00),
+    '<': (0x08, 0x14, 0x22, 0x41, 0x00), '=': (0x14, 0x14, 0x14, 0x14, 0x14),
+    '>': (0x00, 0x41, 0x22, 0x14, 0x08), '?': (0x02, 0x01, 0x51, 0x09, 0x06),
+    '@': (0x32, 0x49, 0x79, 0x41, 0x3E), 'A': (0x7E, 0x11, 0x11, 0x11, 0x7E),
+    'B': (0x7F, 0x49, 0x49, 0x49, 0x36), 'C': (0x3E, 0x41, 0x41, 0x41, 0x22),
+    'D': (0x7F, 0x41, 0x41, 0x22, 0x1C), 'E': (0x7F, 0x49, 0x49, 0x49, 0x41),
+    'F': (0x7F, 0x09, 0x09, 0x09, 0x01), 'G': (0x3E, 0x41, 0x49, 0x49, 0x7A),
+    'H': (0x7F, 0x08, 0x08, 0x08, 0x7F), 'I': (0x00, 0x41, 0x7F, 0x41, 0x00),
+    'J': (0x20, 0x40, 0x41, 0x3F, 0x01), 'K': (0x7F, 0x08, 0x14, 0x22, 0x41),
+    'L': (0x7F, 0x40, 0x40, 0x40, 0x40), 'M': (0x7F, 0x02, 0x0C, 0x02, 0x7F),
+    'N': (0x7F, 0x04, 0x08, 0x10, 0x7F), 'O': (0x3E, 0x41, 0x41, 0x41, 0x3E),
+    'P': (0x7F, 0x09, 0x09, 0x09, 0x06), 'Q': (0x3E, 0x41, 0x51, 0x21, 0x5E),
+    'R': (0x7F, 0x09, 0x19, 0x29, 0x46), 'S': (0x46, 0x49, 0x49, 0x49, 0x31),
+    'T': (0x01, 0x01, 0x7F, 0x01, 0x01), 'U': (0x3F, 0x40, 0x40, 0x40, 0x3F),
+    'V': (0x1F, 0x20, 0x40, 0x20, 0x1F), 'W': (0x3F, 0x40, 0x38, 0x40, 0x3F),
+    'X': (0x63, 0x14, 0x08, 0x14, 0x63), 'Y': (0x07, 0x08, 0x70, 0x08, 0x07),
+    'Z': (0x61, 0x51, 0x49, 0x45, 0x43), '[': (0x00, 0x7F, 0x41, 0x41, 0x00),
+    '\\': (0x02, 0x04, 0x08, 0x10, 0x20), ']': (0x00, 0x41, 0x41, 0x7F, 0x00),
+    '^': (0x04, 0x02, 0x01, 0x02, 0x04), '_': (0x40, 0x40, 0x40, 0x40, 0x40),
+    '`': (0x00, 0x01, 0x02, 0x04, 0x00), 'a': (0x20, 0x54, 0x54, 0x54, 0x78),
+    'b': (0x7F, 0x48, 0x44, 0x44, 0x38), 'c': (0x38, 0x44, 0x44, 0x44, 0x20),
+    'd': (0x38, 0x44, 0x44, 0x48, 0x7F), 'e': (0x38, 0x54, 0x54, 0x54, 0x18),
+    'f': (0x08, 0x7E, 0x09, 0x01, 0x02), 'g': (0x0C, 0x52, 0x52, 0x52, 0x3E),
+    'h': (0x7F, 0x08, 0x04, 0x04, 0x78), 'i': (0x00, 0x44, 0x7D, 0x40, 0x00),
+    'j': (0x20, 0x40, 0x44, 0x3D, 0x00), 'k': (0x7F, 0x10, 0x28, 0x44, 0x00),
+    'l': (0x00, 0x41, 0x7F, 0x40, 0x00), 'm': (0x7C, 0x04, 0x18, 0x04, 0x78),
+    'n': (0x7C, 0x08, 0x04, 0x04, 0x78), 'o': (0x38, 0x44, 0x44, 0x44, 0x38),
+    'p': (0x7C, 0x14, 0x14, 0x14, 0x08), 'q': (0x08, 0x14, 0x14, 0x18, 0x7C),
+    'r': (0x7C, 0x08, 0x04, 0x04, 0x08), 's': (0x48, 0x54, 0x54, 0x54, 0x20),
+    't': (0x04, 0x3F, 0x44, 0x40, 0x20), 'u': (0x3C, 0x40, 0x40, 0x20, 0x7C),
+    'v': (0x1C, 0x20, 0x40, 0x20, 0x1C), 'w': (0x3C, 0x40, 0x30, 0x40, 0x3C),
+    'x': (0x44, 0x28, 0x10, 0x28, 0x44), 'y': (0x0C, 0x50, 0x50, 0x50, 0x3C),
+    'z': (0x44, 0x64, 0x54, 0x4C, 0x44), '{': (0x00, 0x08, 0x36, 0x41, 0x00),
+    '|': (0x00, 0x00, 0x7F, 0x00, 0x00), '}': (0x00, 0x41, 0x36, 0x08, 0x00),
+    '~': (0x08, 0x04, 0x08, 0x10, 0x08),
+}
+
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+CHAR_RE = re.compile(r"'((?:[^'\\\n]|\\.))'")
+ESCAPE_RE = re.compile(r'\\.')
+COMMENT_RE = re.compile(r'//[^\n]*|/\*.*?\*/', re.S)
+
+
+def used_chars():
+    chars = set(ALWAYS)
+    for d in SCAN_DIRS:
+        for dirpath, _, files in os.walk(os.path.join(ROOT, d)):
+            for name in files:
+                if not name.endswith((".c", ".h")) or name.startswith("OLED_Font"):
+                    continue
+                with open(os.path.join(dirpath, name), "rb") as f:
+                    text = f.read().decode("latin-1")
+                text = COMMENT_RE.sub("", text)
+                for m in STRING_RE.finditer(text):
+                    chars.update(ESCAPE_RE.sub("", m.group(1)))
+                for m in CHAR_RE.finditer(text):
+                    chars.update(ESCAPE_RE.sub("", m.group(1)))
+    return sorted(c for c in chars if c in FONT5X7)
+
+
+def main():
+    chars = sorted(FONT5X7) if "--all" in sys.argv else used_chars()
+    index = {c: i for i, c in enumerate(chars)}
+
+    out = []
+    out.append("#ifndef __OLED_FONT6X8_H")
+    out.append("#define __OLED_FONT6X8_H")
+    out.append("")
+    out.append("/*OLED字模库，宽6像素，高8像素")
+    out.append("  由 Tools/gen_font6x8.py 生成，只包含固件字符串用到的字形，请勿手工修改*/")
+    out.append("#define OLED_F6X8_COUNT\t\t%d" % len(chars))
+    out.append("#define OLED_F6X8_NONE\t\t0xFF")
+    out.append("")
+    out.append("const uint8_t OLED_F6x8[][6]=")
+    out.append("{")
+    for c in chars:
+        cols = ",".join("0x%02X" % b for b in (0x00,) + FONT5X7[c])
+        out.append("\t%s,//%s %d" % (cols, c, index[c]))
+    out.append("};")
+    out.append("")
+    out.append("/*字符到字形序号的映射，下标为 字符-' '，0xFF(OLED_F6X8_NONE) 表示未收录*/")
+    out.append("const uint8_t OLED_F6x8_Index[95]=")
+    out.append("{")
+    for row in range(0, 95, 16):
+        vals = []
+        for code in range(row, min(row + 16, 95)):
+            c = chr(code + 32)
+            vals.append("%d" % index[c] if c in index else "0xFF")
+        out.append("\t" + ",".join(vals) + ",")
+    out.append("};")
+    out.append("")
+    out.append("#endif")
+    out.append("")
+
+    with open(OUTPUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out))
+    print("%d glyphs, %d bytes -> %s" % (len(chars), len(chars) * 6, os.path.relpath(OUTPUT, ROOT)))
+
+
+if __name__ == "__main__":
+    main()
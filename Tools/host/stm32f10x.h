@@ -0,0 +1,268 @@
+/*==============================================================================
+  文件：Tools/host/stm32f10x.h
+  功能：主机测试用的最小芯片头文件替身
+        只提供 OLED 硬件 I2C 后端（I2C2 + DMA1 通道 4）和 DHT11 驱动（TIM4 + EXTI12）
+        用到的寄存器结构、位定义和库函数声明；寄存器是普通内存，库函数由测试程序中的
+        总线/传感器模型实现。
+        主机编译时用 -ITools/host 让它先于 Library/ 被找到
+==============================================================================*/
+#ifndef __STM32F10x_H
+#define __STM32F10x_H
+
+#include <stdint.h>
+
+typedef uint32_t u32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+typedef enum {RESET = 0, SET = !RESET} FlagStatus, ITStatus;
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+typedef enum {ERROR = 0, SUCCESS = !ERROR} ErrorStatus;
+
+/*------------------------------ 寄存器 ------------------------------*/
+typedef struct {
+    volatile uint16_t CR1;
+    volatile uint16_t CR2;
+    volatile uint16_t OAR1;
+    volatile uint16_t OAR2;
+    volatile uint16_t DR;
+    volatile uint16_t SR1;
+    volatile uint16_t SR2;
+    volatile uint16_t CCR;
+    volatile uint16_t TRISE;
+} I2C_TypeDef;
+
+typedef struct {
+    volatile uint32_t CCR;
+    volatile uint32_t CNDTR;
+    volatile uint32_t CPAR;
+    volatile uint32_t CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+    volatile uint32_t CRL;
+    volatile uint32_t CRH;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+    volatile uint32_t LCKR;
+} GPIO_TypeDef;
+
+typedef struct {
+    volatile uint16_t CNT;
+    volatile uint16_t CCR1;
+    volatile uint16_t DIER;
+    volatile uint16_t SR;
+} TIM_TypeDef;
+
+// 与芯片相同的成员顺序：EXTI_Init 按 EXTI_Mode/EXTI_Trigger 的偏移访问
+typedef struct {
+    volatile uint32_t IMR;
+    volatile uint32_t EMR;
+    volatile uint32_t RTSR;
+    volatile uint32_t FTSR;
+    volatile uint32_t SWIER;
+    volatile uint32_t PR;
+} EXTI_TypeDef;
+
+extern I2C_TypeDef         host_i2c2;
+extern DMA_Channel_TypeDef host_dma1_channel4;
+extern GPIO_TypeDef        host_gpiob;
+extern TIM_TypeDef         host_tim4;
+extern EXTI_TypeDef        host_exti;
+extern uint32_t            SystemCoreClock;
+
+#define I2C2                (&host_i2c2)
+#define DMA1_Channel4       (&host_dma1_channel4)
+#define GPIOB               (&host_gpiob)
+#define TIM4                (&host_tim4)
+#define EXTI                (&host_exti)
+
+#define I2C_CR1_PE          ((uint16_t)0x0001)
+#define I2C_CR1_START       ((uint16_t)0x0100)
+#define I2C_CR1_STOP        ((uint16_t)0x0200)
+#define I2C_CR2_ITERREN     ((uint16_t)0x0100)
+#define I2C_CR2_ITEVTEN     ((uint16_t)0x0200)
+#define I2C_CR2_DMAEN       ((uint16_t)0x0800)
+#define I2C_SR1_SB          ((uint16_t)0x0001)
+#define I2C_SR1_ADDR        ((uint16_t)0x0002)
+#define I2C_SR1_BTF         ((uint16_t)0x0004)
+#define I2C_SR1_TXE         ((uint16_t)0x0080)
+#define I2C_SR1_BERR        ((uint16_t)0x0100)
+#define I2C_SR1_ARLO        ((uint16_t)0x0200)
+#define I2C_SR1_AF          ((uint16_t)0x0400)
+#define I2C_SR1_OVR         ((uint16_t)0x0800)
+#define DMA_CCR1_EN         ((uint32_t)0x0001)
+#define DMA_CCR1_TCIE       ((uint32_t)0x0002)
+
+/*------------------------------ RCC / GPIO ------------------------------*/
+#define RCC_APB2Periph_GPIOB    0x0008
+#define RCC_APB2Periph_AFIO     0x0001
+#define RCC_APB1Periph_I2C2     0x00400000
+#define RCC_APB1Periph_TIM4     0x00000004
+#define RCC_AHBPeriph_DMA1      0x0001
+#define RCC_APB2PeriphClockCmd(p, s)    ((void)(p), (void)(s))
+#define RCC_APB1PeriphClockCmd(p, s)    ((void)(p), (void)(s))
+#define RCC_AHBPeriphClockCmd(p, s)     ((void)(p), (void)(s))
+
+#define GPIO_Pin_0          ((uint16_t)0x0001)
+#define GPIO_Pin_1          ((uint16_t)0x0002)
+#define GPIO_Pin_10         ((uint16_t)0x0400)
+#define GPIO_Pin_11         ((uint16_t)0x0800)
+#define GPIO_Pin_12         ((uint16_t)0x1000)
+typedef enum {GPIO_Speed_10MHz = 1, GPIO_Speed_2MHz, GPIO_Speed_50MHz} GPIOSpeed_TypeDef;
+typedef enum {GPIO_Mode_Out_OD = 0x14, GPIO_Mode_Out_PP = 0x10,
+              GPIO_Mode_AF_OD = 0x1C, GPIO_Mode_AF_PP = 0x18} GPIOMode_TypeDef;
+typedef struct {
+    uint16_t GPIO_Pin;
+    GPIOSpeed_TypeDef GPIO_Speed;
+    GPIOMode_TypeDef GPIO_Mode;
+} GPIO_InitTypeDef;
+#define GPIO_Init(port, init)   ((void)(port), (void)(init))
+#define GPIO_PortSourceGPIOB    ((uint8_t)0x01)
+#define GPIO_PinSource12        ((uint8_t)0x0C)
+#define GPIO_EXTILineConfig(port, pin)  ((void)(port), (void)(pin))
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t pin);
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t pin);
+
+/*------------------------------ NVIC ------------------------------*/
+typedef enum {DMA1_Channel4_IRQn = 14, TIM4_IRQn = 30, I2C2_EV_IRQn = 33, I2C2_ER_IRQn = 34,
+              EXTI15_10_IRQn = 40} IRQn_Type;
+typedef struct {
+    uint8_t NVIC_IRQChannel;
+    uint8_t NVIC_IRQChannelPreemptionPriority;
+    uint8_t NVIC_IRQChannelSubPriority;
+    FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+#define NVIC_Init(init)         ((void)(init))
+
+uint32_t __get_PRIMASK(void);
+void     __set_PRIMASK(uint32_t primask);
+void     __disable_irq(void);
+#define __NOP()
+
+/*------------------------------ I2C ------------------------------*/
+typedef struct {
+    uint32_t I2C_ClockSpeed;
+    uint16_t I2C_Mode;
+    uint16_t I2C_DutyCycle;
+    uint16_t I2C_OwnAddress1;
+    uint16_t I2C_Ack;
+    uint16_t I2C_AcknowledgedAddress;
+} I2C_InitTypeDef;
+
+#define I2C_Mode_I2C                    ((uint16_t)0x0000)
+#define I2C_DutyCycle_2                 ((uint16_t)0xBFFF)
+#define I2C_Ack_Disable                 ((uint16_t)0x0000)
+#define I2C_AcknowledgedAddress_7bit    ((uint16_t)0x4000)
+#define I2C_Direction_Transmitter       ((uint8_t)0x00)
+#define I2C_IT_ERR                      ((uint16_t)0x0100)
+#define I2C_IT_EVT                      ((uint16_t)0x0200)
+#define I2C_FLAG_BUSY                   ((uint32_t)0x00020000)
+
+// 事件 = (SR2 << 16) | SR1，与库中定义相同
+#define I2C_EVENT_MASTER_MODE_SELECT                ((uint32_t)0x00030001)
+#define I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED  ((uint32_t)0x00070082)
+#define I2C_EVENT_MASTER_BYTE_TRANSMITTING          ((uint32_t)0x00070080)
+#define I2C_EVENT_MASTER_BYTE_TRANSMITTED           ((uint32_t)0x00070084)
+
+void        I2C_DeInit(I2C_TypeDef *I2Cx);
+void        I2C_Init(I2C_TypeDef *I2Cx, I2C_InitTypeDef *init);
+void        I2C_Cmd(I2C_TypeDef *I2Cx, FunctionalState state);
+void        I2C_GenerateSTART(I2C_TypeDef *I2Cx, FunctionalState state);
+void        I2C_GenerateSTOP(I2C_TypeDef *I2Cx, FunctionalState state);
+void        I2C_Send7bitAddress(I2C_TypeDef *I2Cx, uint8_t address, uint8_t direction);
+void        I2C_SendData(I2C_TypeDef *I2Cx, uint8_t data);
+void        I2C_DMACmd(I2C_TypeDef *I2Cx, FunctionalState state);
+void        I2C_ITConfig(I2C_TypeDef *I2Cx, uint16_t it, FunctionalState state);
+ErrorStatus I2C_CheckEvent(I2C_TypeDef *I2Cx, uint32_t event);
+FlagStatus  I2C_GetFlagStatus(I2C_TypeDef *I2Cx, uint32_t flag);
+
+/*------------------------------ DMA ------------------------------*/
+typedef struct {
+    uint32_t DMA_PeripheralBaseAddr;
+    uint32_t DMA_MemoryBaseAddr;
+    uint32_t DMA_DIR;
+    uint32_t DMA_BufferSize;
+    uint32_t DMA_PeripheralInc;
+    uint32_t DMA_MemoryInc;
+    uint32_t DMA_PeripheralDataSize;
+    uint32_t DMA_MemoryDataSize;
+    uint32_t DMA_Mode;
+    uint32_t DMA_Priority;
+    uint32_t DMA_M2M;
+} DMA_InitTypeDef;
+
+#define DMA_DIR_PeripheralDST           ((uint32_t)0x0010)
+#define DMA_PeripheralInc_Disable       ((uint32_t)0x0000)
+#define DMA_MemoryInc_Enable            ((uint32_t)0x0080)
+#define DMA_PeripheralDataSize_Byte     ((uint32_t)0x0000)
+#define DMA_MemoryDataSize_Byte         ((uint32_t)0x0000)
+#define DMA_Mode_Normal                 ((uint32_t)0x0000)
+#define DMA_Priority_High               ((uint32_t)0x2000)
+#define DMA_M2M_Disable                 ((uint32_t)0x0000)
+#define DMA_IT_TC                       ((uint32_t)0x0002)
+#define DMA1_IT_GL4                     ((uint32_t)0x00001000)
+#define DMA1_IT_TC4                     ((uint32_t)0x00002000)
+
+void     DMA_DeInit(DMA_Channel_TypeDef *ch);
+void     DMA_Init(DMA_Channel_TypeDef *ch, DMA_InitTypeDef *init);
+void     DMA_Cmd(DMA_Channel_TypeDef *ch, FunctionalState state);
+void     DMA_ITConfig(DMA_Channel_TypeDef *ch, uint32_t it, FunctionalState state);
+ITStatus DMA_GetITStatus(uint32_t it);
+void     DMA_ClearITPendingBit(uint32_t it);
+
+/*------------------------------ TIM ------------------------------*/
+typedef struct {
+    uint16_t TIM_Prescaler;
+    uint16_t TIM_CounterMode;
+    uint16_t TIM_Period;
+    uint16_t TIM_ClockDivision;
+    uint8_t  TIM_RepetitionCounter;
+} TIM_TimeBaseInitTypeDef;
+
+typedef struct {
+    uint16_t TIM_OCMode;
+    uint16_t TIM_OutputState;
+    uint16_t TIM_OutputNState;
+    uint16_t TIM_Pulse;
+    uint16_t TIM_OCPolarity;
+    uint16_t TIM_OCNPolarity;
+    uint16_t TIM_OCIdleState;
+    uint16_t TIM_OCNIdleState;
+} TIM_OCInitTypeDef;
+
+#define TIM_CKD_DIV1                    ((uint16_t)0x0000)
+#define TIM_CounterMode_Up              ((uint16_t)0x0000)
+#define TIM_OCMode_Timing               ((uint16_t)0x0000)
+#define TIM_IT_CC1                      ((uint16_t)0x0002)
+
+void     TIM_TimeBaseInit(TIM_TypeDef *TIMx, TIM_TimeBaseInitTypeDef *init);
+void     TIM_OCStructInit(TIM_OCInitTypeDef *init);
+void     TIM_OC1Init(TIM_TypeDef *TIMx, TIM_OCInitTypeDef *init);
+void     TIM_Cmd(TIM_TypeDef *TIMx, FunctionalState state);
+void     TIM_ITConfig(TIM_TypeDef *TIMx, uint16_t it, FunctionalState state);
+void     TIM_ClearITPendingBit(TIM_TypeDef *TIMx, uint16_t it);
+void     TIM_SetCompare1(TIM_TypeDef *TIMx, uint16_t compare);
+uint16_t TIM_GetCounter(TIM_TypeDef *TIMx);
+uint16_t TIM_GetCapture1(TIM_TypeDef *TIMx);
+
+/*------------------------------ EXTI ------------------------------*/
+typedef enum {EXTI_Mode_Interrupt = 0x00, EXTI_Mode_Event = 0x04} EXTIMode_TypeDef;
+typedef enum {EXTI_Trigger_Rising = 0x08, EXTI_Trigger_Falling = 0x0C,
+              EXTI_Trigger_Rising_Falling = 0x10} EXTITrigger_TypeDef;
+typedef struct {
+    uint32_t EXTI_Line;
+    EXTIMode_TypeDef EXTI_Mode;
+    EXTITrigger_TypeDef EXTI_Trigger;
+    FunctionalState EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+#define EXTI_Line12                     ((uint32_t)0x01000)
+
+void     EXTI_Init(EXTI_InitTypeDef *init);
+ITStatus EXTI_GetITStatus(uint32_t line);
+void     EXTI_ClearITPendingBit(uint32_t line);
+
+#endif // __STM32F10x_H
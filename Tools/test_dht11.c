@@ -0,0 +1,308 @@
+/*==============================================================================
+  文件：Tools/test_dht11.c
+  功能：DHT11 中断驱动读取的主机测试（虚拟时间，1us 一步）
+        直接包含 Hardware/dht11.c，TIM4/EXTI 由 Tools/host/stm32f10x.h 提供为普通内存；
+        EXTI_Init 按库函数的写法实现（LineCmd=DISABLE 时只清模式位，不写触发寄存器），
+        只有 FTSR 置位的下降沿才会挂起 PR，PR 与 IMR 同时置位才进入 EXTI15_10 中断。
+        传感器模型：主机拉低至少 18ms 后释放，30us 后应答低 80us、高 80us，
+        每位低 50us + 高 26us（0）或 70us（1），最后低 50us 后释放。
+        检查：EXTI 触发配置、42 个下降沿解码、校验错误、数据不完整、无应答、
+        失败退避间隔与缓存失效
+  编译：gcc -std=gnu99 -Wall -ITools/host -IHardware -ISystem -DTRACE_ENABLE=0 -D'ISR_CYCLES()=0'
+            Tools/test_dht11.c -o test_dht11 && ./test_dht11
+==============================================================================*/
+#include <stdio.h>
+#include <string.h>
+#include "dht11.c"
+
+#define MAX_READ_US         50000       // 单次读取的步数上限，超过视为卡死
+#define READ_SPAN_MS        40          // 启动到完成（起始低电平 20ms + 帧或超时 10ms）再加轮询误差
+
+GPIO_TypeDef host_gpiob;
+TIM_TypeDef  host_tim4;
+EXTI_TypeDef host_exti;
+uint32_t     SystemCoreClock = 72000000;
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                         failures++; } } while (0)
+
+/*------------------------------ 时基、中断与统计替身 ------------------------------*/
+static uint32_t now_us;
+static uint32_t primask = 0;
+
+uint32_t Time_Ms(void) { return now_us / 1000; }
+uint32_t Time_CyclesPerUs(void) { return 72; }
+uint32_t __get_PRIMASK(void) { return primask; }
+void __set_PRIMASK(uint32_t value) { primask = value; }
+void __disable_irq(void) { primask = 1; }
+void IsrStat_Enter(IsrStat_Id_t id, uint32_t latency) { (void)id; (void)latency; }
+void IsrStat_Exit(IsrStat_Id_t id, uint32_t cycles) { (void)id; (void)cycles; }
+
+/*------------------------------ 传感器模型 ------------------------------*/
+#define MAX_LOWS    (1 + 40 + 1)
+
+static struct {
+    uint8_t  present;
+    uint8_t  frame[5];
+    uint8_t  bits;                  // 实际发送的位数（小于 40 模拟数据不完整）
+    uint32_t low_start[MAX_LOWS];   // 传感器拉低的区间
+    uint32_t low_end[MAX_LOWS];
+    uint8_t  lows;
+} sensor;
+
+static uint8_t  mcu_low = 0;        // 主机拉低总线
+static uint32_t mcu_low_since;
+static uint32_t start_ms[8];        // 每次读取启动的时刻
+static uint8_t  starts;
+
+static void Sensor_Set(uint8_t present, uint8_t humidity, uint8_t temperature, uint8_t checksum_error,
+                       uint8_t bits)
+{
+    sensor.present = present;
+    sensor.frame[0] = humidity;
+    sensor.frame[1] = 0;
+    sensor.frame[2] = temperature;
+    sensor.frame[3] = 0;
+    sensor.frame[4] = (uint8_t)(humidity + temperature + checksum_error);
+    sensor.bits = bits;
+}
+
+static void Sensor_Respond(uint32_t t)
+{
+    sensor.lows = 0;
+    t += 30;
+    sensor.low_start[sensor.lows] = t;
+    sensor.low_end[sensor.lows++] = t + 80;
+    t += 80 + 80;
+    for (uint8_t i = 0; i < sensor.bits; i++) {
+        uint8_t one = (sensor.frame[i >> 3] >> (7 - (i & 7))) & 1;
+        sensor.low_start[sensor.lows] = t;
+        sensor.low_end[sensor.lows++] = t + 50;
+        t += 50 + (one ? 70 : 26);
+    }
+    if (sensor.bits == 40) {
+        sensor.low_start[sensor.lows] = t;
+        sensor.low_end[sensor.lows++] = t + 50;
+    }
+}
+
+static uint8_t Line_Level(void)
+{
+    if (mcu_low) return 0;
+    for (uint8_t i = 0; i < sensor.lows; i++) {
+        if (now_us >= sensor.low_start[i] && now_us < sensor.low_end[i]) return 0;
+    }
+    return 1;
+}
+
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t pin)
+{
+    (void)GPIOx; (void)pin;
+    mcu_low = 1;
+    mcu_low_since = now_us;
+    sensor.lows = 0;
+    if (starts < 8) start_ms[starts] = Time_Ms();
+    starts++;
+}
+
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t pin)
+{
+    (void)GPIOx; (void)pin;
+    if (mcu_low && sensor.present && now_us - mcu_low_since >= 18000) Sensor_Respond(now_us);
+    mcu_low = 0;
+}
+
+/*------------------------------ TIM4 / EXTI ------------------------------*/
+void TIM_TimeBaseInit(TIM_TypeDef *TIMx, TIM_TimeBaseInitTypeDef *init) { (void)TIMx; (void)init; }
+void TIM_OCStructInit(TIM_OCInitTypeDef *init) { memset(init, 0, sizeof(*init)); }
+void TIM_OC1Init(TIM_TypeDef *TIMx, TIM_OCInitTypeDef *init) { (void)TIMx; (void)init; }
+void TIM_Cmd(TIM_TypeDef *TIMx, FunctionalState state) { (void)TIMx; (void)state; }
+void TIM_SetCompare1(TIM_TypeDef *TIMx, uint16_t compare) { TIMx->CCR1 = compare; }
+uint16_t TIM_GetCounter(TIM_TypeDef *TIMx) { return TIMx->CNT; }
+uint16_t TIM_GetCapture1(TIM_TypeDef *TIMx) { return TIMx->CCR1; }
+void TIM_ClearITPendingBit(TIM_TypeDef *TIMx, uint16_t it) { TIMx->SR &= ~it; }
+
+void TIM_ITConfig(TIM_TypeDef *TIMx, uint16_t it, FunctionalState state)
+{
+    if (state) TIMx->DIER |= it; else TIMx->DIER &= ~it;
+}
+
+// 与库函数相同：DISABLE 只清除模式寄存器中的位
+void EXTI_Init(EXTI_InitTypeDef *init)
+{
+    volatile uint32_t *mode = (volatile uint32_t *)((uint8_t *)EXTI + init->EXTI_Mode);
+
+    if (init->EXTI_LineCmd != DISABLE) {
+        EXTI->IMR &= ~init->EXTI_Line;
+        EXTI->EMR &= ~init->EXTI_Line;
+        *mode |= init->EXTI_Line;
+        EXTI->RTSR &= ~init->EXTI_Line;
+        EXTI->FTSR &= ~init->EXTI_Line;
+        if (init->EXTI_Trigger == EXTI_Trigger_Rising_Falling) {
+            EXTI->RTSR |= init->EXTI_Line;
+            EXTI->FTSR |= init->EXTI_Line;
+        } else {
+            *(volatile uint32_t *)((uint8_t *)EXTI + init->EXTI_Trigger) |= init->EXTI_Line;
+        }
+    } else {
+        *mode &= ~init->EXTI_Line;
+    }
+}
+
+ITStatus EXTI_GetITStatus(uint32_t line)
+{
+    return ((EXTI->PR & line) && (EXTI->IMR & line)) ? SET : RESET;
+}
+
+void EXTI_ClearITPendingBit(uint32_t line)
+{
+    EXTI->PR &= ~line;
+}
+
+/**
+  * @brief  推进 1us：TIM4 计数与比较，总线下降沿挂起 EXTI12，按挂起情况调用中断函数
+  */
+static void Step(void)
+{
+    static uint8_t last_level = 1;
+    uint8_t level;
+
+    now_us++;
+    TIM4->CNT = (uint16_t)now_us;
+    if ((TIM4->DIER & TIM_IT_CC1) && TIM4->CNT == TIM4->CCR1) TIM4->SR |= TIM_IT_CC1;
+
+    level = Line_Level();
+    if (last_level && !level && (EXTI->FTSR & EXTI_Line12)) EXTI->PR |= EXTI_Line12;
+    last_level = level;
+
+    if ((TIM4->SR & TIM4->DIER & TIM_IT_CC1) && !primask) TIM4_IRQHandler();
+    if ((EXTI->PR & EXTI->IMR & EXTI_Line12) && !primask) EXTI15_10_IRQHandler();
+}
+
+/*------------------------------ 读取 ------------------------------*/
+static uint8_t cb_status, cb_humidity, cb_temperature, cb_count;
+
+static void Done(u8 humidity, u8 temperature, u8 status)
+{
+    cb_humidity = humidity;
+    cb_temperature = temperature;
+    cb_status = status;
+    cb_count++;
+}
+
+/**
+  * @brief  每 1ms 调用一次 DHT11_Poll，直到启动一次读取并结束
+  * @retval 完成状态，0xFF 表示未结束
+  */
+static uint8_t Read(void)
+{
+    uint8_t count = cb_count;
+
+    while (DHT11_Poll(Done) != 0) {
+        for (uint16_t i = 0; i < 1000; i++) Step();
+    }
+    for (uint32_t i = 0; i < MAX_READ_US && DHT11_IsBusy(); i++) Step();
+    CHECK(!DHT11_IsBusy() && cb_count == count + 1);
+    return DHT11_IsBusy() ? 0xFF : cb_status;
+}
+
+static void Setup(void)
+{
+    memset(&host_exti, 0, sizeof(host_exti));
+    memset(&host_tim4, 0, sizeof(host_tim4));
+    now_us = 0;
+    starts = 0;
+    DHT11_Init();
+}
+
+static void Test_Config(void)
+{
+    Setup();
+    CHECK(EXTI->FTSR & EXTI_Line12);            // 下降沿触发已配置
+    CHECK(!(EXTI->RTSR & EXTI_Line12));
+    CHECK(!(EXTI->IMR & EXTI_Line12));          // 读取开始前屏蔽
+    CHECK(DHT11_Poll(Done) == 1);               // 上电 1s 内不读取
+}
+
+static void Test_Decode(void)
+{
+    DHT11_Sample_t s;
+
+    Setup();
+    Sensor_Set(1, 56, 23, 0, 40);
+    CHECK(Read() == DHT11_OK);
+    CHECK(dht_edges == 42);
+    CHECK(cb_humidity == 56 && cb_temperature == 23);
+    DHT11_GetSample(&s);
+    CHECK(s.valid && s.humidity == 56 && s.temperature == 23 && s.failures == 0);
+    CHECK(!(EXTI->IMR & EXTI_Line12));          // 结束后重新屏蔽
+
+    // 交替的 0/1 位；下一次读取在上次完成 1s 后启动
+    Sensor_Set(1, 0xAA, 0x55, 0, 40);
+    CHECK(Read() == DHT11_OK);
+    CHECK(cb_humidity == 0xAA && cb_temperature == 0x55);
+    CHECK(starts == 2 && start_ms[1] - start_ms[0] >= DHT11_PERIOD_MS);
+    CHECK(start_ms[1] - start_ms[0] <= DHT11_PERIOD_MS + READ_SPAN_MS);
+}
+
+static void Test_Errors(void)
+{
+    DHT11_Sample_t s;
+
+    Setup();
+    Sensor_Set(1, 40, 20, 0, 40);
+    CHECK(Read() == DHT11_OK);
+
+    // 校验错误：缓存保留上次成功的值
+    Sensor_Set(1, 60, 30, 1, 40);
+    CHECK(Read() == DHT11_ERR_CHECKSUM);
+    DHT11_GetSample(&s);
+    CHECK(s.valid && s.humidity == 40 && s.temperature == 20 && s.failures == 1);
+
+    // 只发 20 位后停止
+    Sensor_Set(1, 60, 30, 0, 20);
+    CHECK(Read() == DHT11_ERR_TIMEOUT);
+    CHECK(dht_edges > 0 && dht_edges < 42);
+
+    // 成功后失败计数清零
+    Sensor_Set(1, 61, 31, 0, 40);
+    CHECK(Read() == DHT11_OK);
+    DHT11_GetSample(&s);
+    CHECK(s.failures == 0 && s.humidity == 61);
+}
+
+static void Test_Backoff(void)
+{
+    static const uint32_t expected[] = {1000, 2000, 4000, 8000, 8000};
+    DHT11_Sample_t s;
+
+    Setup();
+    Sensor_Set(1, 50, 25, 0, 40);
+    CHECK(Read() == DHT11_OK);
+
+    Sensor_Set(0, 0, 0, 0, 0);
+    starts = 0;
+    for (uint8_t i = 0; i < 6; i++) {
+        CHECK(Read() == DHT11_ERR_NO_RESPONSE);
+        CHECK(dht_edges == 0);
+    }
+    for (uint8_t i = 0; i < 5; i++) {
+        uint32_t interval = start_ms[i + 1] - start_ms[i];
+        CHECK(interval >= expected[i] && interval <= expected[i] + READ_SPAN_MS);
+    }
+    DHT11_GetSample(&s);
+    CHECK(!s.valid && s.failures == 6 && s.humidity == 50);
+}
+
+int main(void)
+{
+    Test_Config();
+    Test_Decode();
+    Test_Errors();
+    Test_Backoff();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures != 0;
+}
@@ -0,0 +1,145 @@
+/*==============================================================================
+  文件：Tools/test_echofilter.c
+  功能：EchoFilter 的主机测试（超声 20Hz，每 50ms 一个样本，距离单位 0.1cm）
+        直接包含 System/EchoFilter.c，用几段典型回波序列检查滤波输出：
+        单次杂波/单次超时、周期性鬼影回波、匀速接近、阶跃、样本中断后失效、限幅
+  编译：gcc -std=gnu99 -Wall -ISystem Tools/test_echofilter.c -o test_echofilter && ./test_echofilter
+==============================================================================*/
+#include <stdio.h>
+#include <stdint.h>
+
+#include "EchoFilter.c"
+
+#define SAMPLE_US   50000
+
+static EchoFilter_t f;
+static uint32_t now_us;
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                         failures++; } } while (0)
+
+static void Reset(void)
+{
+    EchoFilter_Init(&f);
+    now_us = 1000000;
+}
+
+static uint16_t Feed(uint16_t raw)
+{
+    now_us += SAMPLE_US;
+    return EchoFilter_Add(&f, raw, now_us);
+}
+
+static void Feed_Repeat(uint16_t raw, uint8_t n)
+{
+    while (n--) Feed(raw);
+}
+
+// 稳定 100cm 中夹一个近距离杂波和一次超时：输出不变，杂波计为离群
+static void Test_Spike(void)
+{
+    Reset();
+    Feed_Repeat(1000, 5);
+    CHECK(Feed(300) == 1000);
+    CHECK(f.outliers == 1);
+    CHECK(Feed(1000) == 1000);
+    CHECK(Feed(ECHO_FILTER_NONE) == 1000);
+    CHECK(f.outliers == 2);
+    CHECK(Feed(1000) == 1000);
+    CHECK(EchoFilter_Distance(&f, now_us) == 1000);
+    CHECK(f.confidence >= 60);
+}
+
+// 150cm 处的障碍，每三个样本有一个 50cm 的鬼影（上一周期的多次反射）：输出不跟随鬼影
+static void Test_GhostEcho(void)
+{
+    uint16_t out;
+
+    Reset();
+    Feed_Repeat(1500, 5);
+    for (uint8_t i = 0; i < 30; i++) {
+        out = Feed(i % 3 == 2 ? 500 : 1500);
+        CHECK(out == 1500);
+    }
+    CHECK(f.outliers == 10);
+    CHECK(EchoFilter_Distance(&f, now_us) == 1500);
+}
+
+// 从 200cm 以 40cm/s（每样本 2cm）接近到 50cm：中值滞后不超过两个样本，不产生离群
+static void Test_Approach(void)
+{
+    uint16_t out;
+
+    Reset();
+    for (uint16_t d = 2000; d >= 500; d -= 20) {
+        out = Feed(d);
+        if (f.count == ECHO_FILTER_SIZE) {
+            CHECK(out >= d && out - d <= 2 * 20);
+        }
+    }
+    CHECK(f.outliers == 0);
+    CHECK(EchoFilter_Age(&f, now_us) == 0);
+}
+
+// 障碍突然出现：连续三个样本后输出切换；障碍移开后多数无回波时输出无障碍
+static void Test_Step(void)
+{
+    Reset();
+    Feed_Repeat(ECHO_FILTER_NONE, 5);
+    CHECK(f.distance == ECHO_FILTER_NONE);
+    CHECK(Feed(800) == ECHO_FILTER_NONE);
+    CHECK(Feed(800) == ECHO_FILTER_NONE);
+    CHECK(Feed(800) == 800);
+    Feed_Repeat(800, 2);
+    CHECK(Feed(ECHO_FILTER_NONE) == 800);
+    CHECK(Feed(ECHO_FILTER_NONE) == 800);
+    CHECK(Feed(ECHO_FILTER_NONE) == ECHO_FILTER_NONE);
+}
+
+// 样本中断（传感器断线）：超过 ECHO_FILTER_STALE_US 后输出无效；从未有样本时也无效
+static void Test_Stale(void)
+{
+    Reset();
+    CHECK(EchoFilter_Distance(&f, now_us) == ECHO_FILTER_NONE);
+
+    Feed_Repeat(1200, 5);
+    CHECK(EchoFilter_Distance(&f, now_us + ECHO_FILTER_STALE_US) == 1200);
+    CHECK(EchoFilter_Distance(&f, now_us + ECHO_FILTER_STALE_US + 1) == ECHO_FILTER_NONE);
+
+    // 样本持续到来但都是离群点时，时间戳不更新，同样失效
+    uint32_t last = now_us;
+    Feed(300);
+    Feed(3000);
+    CHECK(f.time_us == last);
+    CHECK(EchoFilter_Age(&f, now_us) == 2 * SAMPLE_US);
+}
+
+// 限幅：过近按 2.0cm，超过 400cm 按无障碍
+static void Test_Clamp(void)
+{
+    Reset();
+    Feed_Repeat(5, 5);
+    CHECK(f.distance == ECHO_FILTER_MIN);
+    CHECK(f.outliers == 0);
+
+    Reset();
+    Feed_Repeat(ECHO_FILTER_MAX, 3);
+    CHECK(f.distance == ECHO_FILTER_MAX);
+    Feed_Repeat(ECHO_FILTER_MAX + 1, 3);
+    CHECK(f.distance == ECHO_FILTER_NONE);
+    CHECK(f.window[(f.head + ECHO_FILTER_SIZE - 1) % ECHO_FILTER_SIZE] == ECHO_FILTER_NONE);
+}
+
+int main(void)
+{
+    Test_Spike();
+    Test_GhostEcho();
+    Test_Approach();
+    Test_Step();
+    Test_Stale();
+    Test_Clamp();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures != 0;
+}
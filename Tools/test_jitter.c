@@ -0,0 +1,139 @@
+/*==============================================================================
+  文件：Tools/test_jitter.c
+  功能：Jitter 的主机测试
+        直接包含 System/Kernel.c（KERNEL_HOST 模型，提供 Kernel_Lock/Unlock）与
+        System/Jitter.c，JITTER_NOW() 换成可由测试设定的 host_us()。
+        检查：周期最小/最大/平均、释放延迟（早于释放按 0 计）、直方图分档边界、
+        超时计数、清零在下一个周期开始时生效、分档上限
+  编译：gcc -std=gnu99 -Wall -D'JITTER_NOW()=host_us()' -DKERNEL_HOST -ISystem Tools/test_jitter.c -o test_jitter && ./test_jitter
+==============================================================================*/
+#include <stdio.h>
+#include <stdint.h>
+
+static uint32_t now_us;
+
+static uint32_t host_us(void)
+{
+    return now_us;
+}
+
+#include "Kernel.c"
+#include "Jitter.c"
+
+#define PERIOD_US   20000
+#define DEADLINE_US 5000
+
+uint32_t kernel_host_now = 0;
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                         failures++; } } while (0)
+
+// 一个控制周期：release 时刻释放，延迟 latency 后开始，再过 work 完成
+static void Cycle(uint32_t release, uint32_t latency, uint32_t work)
+{
+    now_us = release + latency;
+    Jitter_CycleStart(release);
+    now_us += work;
+    Jitter_CycleEnd();
+}
+
+static void Test_Period(void)
+{
+    Jitter_Stats_t s;
+
+    Jitter_Init(DEADLINE_US);
+    Jitter_GetStats(&s);
+    CHECK(s.cycles == 0 && s.period_min == 0 && s.period_mean == 0);
+
+    // 开始时刻 10、20030、40000、60040：间隔 20020、19970、20040
+    Cycle(0, 10, 300);
+    Cycle(PERIOD_US, 30, 300);
+    Cycle(2 * PERIOD_US, 0, 300);
+    Cycle(3 * PERIOD_US, 40, 300);
+    Jitter_GetStats(&s);
+    CHECK(s.cycles == 4);
+    CHECK(s.period_min == 19970 && s.period_max == 20040);
+    CHECK(s.period_mean == (20020 + 19970 + 20040) / 3);
+    CHECK(s.latency_max == 40);
+    CHECK(s.response_max == 340 && s.misses == 0);
+
+    // 释放时刻由毫秒节拍换算，开始早于释放时延迟按 0 计，响应时间同样不为负
+    Jitter_Init(DEADLINE_US);
+    now_us = 995;
+    Jitter_CycleStart(1000);
+    Jitter_CycleEnd();
+    Jitter_GetStats(&s);
+    CHECK(s.latency_max == 0 && s.response_max == 0 && s.histogram[0] == 1);
+}
+
+static void Test_Histogram(void)
+{
+    Jitter_Stats_t s;
+    uint32_t release = 0;
+
+    Jitter_Init(DEADLINE_US);
+    Cycle(release += PERIOD_US, 0, 49);         // < 50us
+    Cycle(release += PERIOD_US, 0, 50);         // 上限不含，进入 50~100us
+    Cycle(release += PERIOD_US, 0, 999);        // 500us~1ms
+    Cycle(release += PERIOD_US, 0, 1000);       // 1~2ms
+    Cycle(release += PERIOD_US, 0, DEADLINE_US);        // 等于截止时间不算超时
+    Cycle(release += PERIOD_US, 0, DEADLINE_US + 1);
+    Cycle(release += PERIOD_US, 0, 19999);      // 10~20ms
+    Cycle(release += PERIOD_US, 0, 20000);      // 超出上限
+    Cycle(release += PERIOD_US, 0, 100000);
+    Jitter_GetStats(&s);
+
+    CHECK(s.histogram[0] == 1 && s.histogram[1] == 1 && s.histogram[2] == 0);
+    CHECK(s.histogram[4] == 1 && s.histogram[5] == 1);
+    CHECK(s.histogram[6] == 0 && s.histogram[7] == 2);     // 5000 与 5001 同在 5~10ms
+    CHECK(s.histogram[8] == 1 && s.histogram[9] == 2);
+    CHECK(s.misses == 4 && s.response_max == 100000 && s.cycles == 9);
+}
+
+static void Test_Reset(void)
+{
+    Jitter_Stats_t s;
+
+    Jitter_Init(DEADLINE_US);
+    Cycle(0, 100, DEADLINE_US + 1);
+    Cycle(PERIOD_US, 0, 200);
+
+    // 清零请求在下一个周期开始时才生效，之前读到的仍是原统计
+    Jitter_Reset();
+    Jitter_GetStats(&s);
+    CHECK(s.cycles == 2 && s.misses == 1);
+
+    Cycle(2 * PERIOD_US, 20, 200);
+    Jitter_GetStats(&s);
+    CHECK(s.cycles == 1 && s.misses == 0 && s.latency_max == 20 && s.response_max == 220);
+    CHECK(s.histogram[3] == 1 && s.histogram[9] == 0);      // 220us 在 200~500us
+    CHECK(s.period_min == 0 && s.period_max == 0);          // 清零后第一个周期没有间隔
+
+    Cycle(3 * PERIOD_US, 0, 200);
+    Jitter_GetStats(&s);
+    CHECK(s.period_min == PERIOD_US - 20 && s.period_mean == PERIOD_US - 20);
+}
+
+static void Test_BucketLimit(void)
+{
+    CHECK(Jitter_BucketLimit(0) == 50);
+    CHECK(Jitter_BucketLimit(4) == 1000);
+    CHECK(Jitter_BucketLimit(JITTER_BUCKETS - 2) == 20000);
+    CHECK(Jitter_BucketLimit(JITTER_BUCKETS - 1) == 0);
+    for (uint8_t i = 1; i < JITTER_BUCKETS - 1; i++) {
+        CHECK(Jitter_BucketLimit(i) > Jitter_BucketLimit(i - 1));
+    }
+}
+
+int main(void)
+{
+    Test_Period();
+    Test_Histogram();
+    Test_Reset();
+    Test_BucketLimit();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures != 0;
+}
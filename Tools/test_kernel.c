@@ -0,0 +1,195 @@
+/*==============================================================================
+  文件：Tools/test_kernel.c
+  功能：Kernel 的主机测试（KERNEL_HOST 模型）
+        直接包含 System/Kernel.c：挂起切换即立即改变当前线程，时间由 kernel_host_now
+        推进，Kernel_Tick 由测试代码代替 SysTick 调用。线程函数不会真正运行，测试以
+        “当前线程”的身份调用阻塞接口，再检查状态、当前线程与 wait_result。
+        注意：主机模型中阻塞调用立即返回，返回值不代表唤醒结果，须看 wait_result。
+        检查：初始栈帧、优先级选择、延时与唤醒、固定速率跳过、信号量等待/释放/超时、
+        多个等待者、锁定禁止抢占、消息队列
+  编译：gcc -std=gnu99 -Wall -DKERNEL_HOST -ISystem Tools/test_kernel.c -o test_kernel && ./test_kernel
+==============================================================================*/
+#include <stdio.h>
+#include <stdint.h>
+
+#include "Kernel.c"
+
+uint32_t kernel_host_now = 0;
+
+static Kernel_Thread_t hi, mid, idle;
+static uint64_t stack_hi[32], stack_mid[32], stack_idle[32];
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                         failures++; } } while (0)
+
+// 线程函数在主机上不会被调用，用奇数地址模拟 Thumb 函数指针
+#define FAKE_ENTRY  ((Kernel_Entry_t)(uintptr_t)0x08000101)
+
+static void Tick(uint32_t now)
+{
+    kernel_host_now = now;
+    Kernel_Tick();
+}
+
+static void Setup(void)
+{
+    kernel_host_now = 0;
+    Kernel_Init();
+    Kernel_CreateThread(&hi, "HI", FAKE_ENTRY, 0, stack_hi, sizeof(stack_hi));
+    Kernel_CreateThread(&mid, "MID", FAKE_ENTRY, 1, stack_mid, sizeof(stack_mid));
+    Kernel_CreateThread(&idle, "IDLE", FAKE_ENTRY, 4, stack_idle, sizeof(stack_idle));
+    Kernel_Start();
+}
+
+static void Test_InitialFrame(void)
+{
+    Setup();
+    // sp 指向 r4，之后 r5~r11、r0~r3、r12、LR、PC、xPSR
+    CHECK(hi.sp == (uint32_t *)stack_hi + sizeof(stack_hi) / 4 - 16);
+    CHECK(hi.sp[14] == 0x08000100);
+    CHECK(hi.sp[15] == 0x01000000);
+    CHECK(hi.sp[13] == (uint32_t)(uintptr_t)Kernel_ThreadExit);
+    CHECK(Kernel_GetStackFree(&hi) == sizeof(stack_hi) - 16 * 4);
+    CHECK(Kernel_GetThread(0) == &hi && Kernel_GetThread(2) == &idle && Kernel_GetThread(3) == 0);
+}
+
+static void Test_Delay(void)
+{
+    Setup();
+    CHECK(Kernel_Current() == &hi);
+
+    Kernel_Delay(10);
+    CHECK(hi.state == KERNEL_SLEEPING && Kernel_Current() == &mid);
+    Tick(9);
+    CHECK(Kernel_Current() == &mid);
+    Tick(10);
+    CHECK(hi.state == KERNEL_READY && Kernel_Current() == &hi);
+
+    // 固定速率：周期 20ms，65ms 才调用时 20/40/60 已错过，睡到 80
+    uint32_t wake = 0;
+    kernel_host_now = 65;
+    Kernel_DelayUntil(&wake, 20);
+    CHECK(wake == 80 && hi.wake_time == 80 && Kernel_Current() == &mid);
+    Tick(79);
+    CHECK(Kernel_Current() == &mid);
+    Tick(80);
+    CHECK(Kernel_Current() == &hi);
+
+    // 已到期的 SleepUntil 不让出
+    Kernel_SleepUntil(80);
+    CHECK(hi.state == KERNEL_READY && Kernel_Current() == &hi);
+}
+
+static void Test_Semaphore(void)
+{
+    Kernel_Sem_t sem;
+
+    Setup();
+    Kernel_SemInit(&sem, 0, 2);
+
+    // 一直等待：释放后唤醒并立即抢占
+    Kernel_SemWait(&sem, KERNEL_WAIT_FOREVER);
+    CHECK(hi.state == KERNEL_BLOCKED && Kernel_Current() == &mid);
+    Tick(1000);
+    CHECK(hi.state == KERNEL_BLOCKED);
+    Kernel_SemPost(&sem);
+    CHECK(hi.wait_result == 1 && hi.wait_obj == 0 && Kernel_Current() == &hi);
+    CHECK(sem.count == 0);
+
+    // 超时：到期前不唤醒，到期后 wait_result 为 0
+    kernel_host_now = 2000;
+    Kernel_SemWait(&sem, 5);
+    CHECK(Kernel_Current() == &mid);
+    Tick(2004);
+    CHECK(hi.state == KERNEL_BLOCKED);
+    Tick(2005);
+    CHECK(hi.state == KERNEL_READY && hi.wait_result == 0 && hi.wait_obj == 0);
+    CHECK(Kernel_Current() == &hi);
+
+    // 超时后的释放不再交给 hi，而是计数
+    Kernel_SemPost(&sem);
+    CHECK(sem.count == 1);
+
+    // 无等待者时计数到上限为止；有计数时不阻塞
+    Kernel_SemPost(&sem);
+    Kernel_SemPost(&sem);
+    CHECK(sem.count == 2);
+    CHECK(Kernel_SemWait(&sem, KERNEL_NO_WAIT) == 1 && sem.count == 1);
+    CHECK(Kernel_SemWait(&sem, KERNEL_WAIT_FOREVER) == 1 && sem.count == 0);
+    CHECK(Kernel_SemWait(&sem, KERNEL_NO_WAIT) == 0 && Kernel_Current() == &hi);
+
+    // 两个等待者：每次释放交给优先级最高的一个
+    Kernel_SemWait(&sem, KERNEL_WAIT_FOREVER);
+    Kernel_SemWait(&sem, KERNEL_WAIT_FOREVER);
+    CHECK(hi.state == KERNEL_BLOCKED && mid.state == KERNEL_BLOCKED && Kernel_Current() == &idle);
+    Kernel_SemPost(&sem);
+    CHECK(hi.state == KERNEL_READY && mid.state == KERNEL_BLOCKED && Kernel_Current() == &hi);
+    Kernel_SemPost(&sem);
+    CHECK(mid.state == KERNEL_READY && mid.wait_result == 1 && Kernel_Current() == &hi);
+}
+
+static void Test_Lock(void)
+{
+    Kernel_Sem_t sem;
+
+    Setup();
+    Kernel_SemInit(&sem, 0, 1);
+    Kernel_SemWait(&sem, KERNEL_WAIT_FOREVER);
+    CHECK(Kernel_Current() == &mid);
+
+    // 锁定期间唤醒高优先级线程不切换，解锁时切换；锁可嵌套
+    Kernel_Lock();
+    Kernel_Lock();
+    Kernel_SemPost(&sem);
+    CHECK(hi.state == KERNEL_READY && Kernel_Current() == &mid);
+    Kernel_Unlock();
+    CHECK(Kernel_Current() == &mid);
+    Kernel_Unlock();
+    CHECK(Kernel_Current() == &hi);
+
+    // 锁定期间等待信号量不阻塞
+    Kernel_Lock();
+    CHECK(Kernel_SemWait(&sem, KERNEL_WAIT_FOREVER) == 0);
+    CHECK(hi.state == KERNEL_READY && Kernel_Current() == &hi);
+    Kernel_Unlock();
+}
+
+static void Test_Queue(void)
+{
+    Kernel_Queue_t q;
+    uint32_t buffer[3];
+    uint32_t msg = 0;
+
+    Setup();
+    Kernel_QueueInit(&q, buffer, 3);
+
+    CHECK(Kernel_QueueGet(&q, &msg, KERNEL_NO_WAIT) == 0);
+    CHECK(Kernel_QueuePut(&q, 1) && Kernel_QueuePut(&q, 2) && Kernel_QueuePut(&q, 3));
+    CHECK(Kernel_QueuePut(&q, 4) == 0);
+    CHECK(Kernel_QueueGet(&q, &msg, KERNEL_NO_WAIT) && msg == 1);
+    CHECK(Kernel_QueuePut(&q, 4));                                  // 绕回
+    CHECK(Kernel_QueueGet(&q, &msg, KERNEL_NO_WAIT) && msg == 2);
+    CHECK(Kernel_QueueGet(&q, &msg, KERNEL_NO_WAIT) && msg == 3);
+    CHECK(Kernel_QueueGet(&q, &msg, KERNEL_NO_WAIT) && msg == 4);
+    CHECK(Kernel_QueueGet(&q, &msg, KERNEL_NO_WAIT) == 0 && q.used == 0);
+
+    // 空队列上等待：放入消息唤醒等待者（消息计数直接交给它）
+    Kernel_QueueGet(&q, &msg, KERNEL_WAIT_FOREVER);
+    CHECK(hi.state == KERNEL_BLOCKED && Kernel_Current() == &mid);
+    CHECK(Kernel_QueuePut(&q, 5));
+    CHECK(hi.wait_result == 1 && Kernel_Current() == &hi);
+    CHECK(q.used == 1 && q.items.count == 0);
+}
+
+int main(void)
+{
+    Test_InitialFrame();
+    Test_Delay();
+    Test_Semaphore();
+    Test_Lock();
+    Test_Queue();
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures != 0;
+}
@@ -0,0 +1,359 @@
+/*==============================================================================
+  文件：Tools/test_oled_i2c.c
+  功能：OLED 硬件 I2C2 + DMA 后端的主机测试
+        直接包含 Hardware/OLED.c，I2C2/DMA1 通道 4 的寄存器由 Tools/host/stm32f10x.h
+        提供为普通内存，这里的总线模型按字节推进：起始/停止、地址应答、DR 移位、
+        DMA 搬运与传输完成、BTF，并在 PRIMASK 打开时调用对应的中断函数。
+        总线上的字节交给一个 SSD1306 页寻址模型写入 GDDRAM，最后与显存逐字节比较。
+        检查：每页一次传输、页间为重复起始、STOP 未清零前不写 CR1、中断统计成对、
+        刷新中再次请求会补扫、地址无应答后该页重新标脏。
+  编译：gcc -std=gnu99 -Wall -Wno-pointer-to-int-cast -Wno-missing-braces
+            -ITools/host -IHardware -ISystem
+            -DOLED_USE_HW_I2C=1 -DTRACE_ENABLE=0 -D'ISR_CYCLES()=0'
+            Tools/test_oled_i2c.c -o test_oled_i2c && ./test_oled_i2c
+==============================================================================*/
+#include <stdio.h>
+#include <string.h>
+#include "OLED.c"
+
+#define MAX_STEPS           100000      // 单次运行的总线步数上限，超过视为卡死
+
+I2C_TypeDef         host_i2c2;
+DMA_Channel_TypeDef host_dma1_channel4;
+GPIO_TypeDef        host_gpiob;
+
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                         failures++; } } while (0)
+
+/*------------------------------ 中断与统计替身 ------------------------------*/
+static uint32_t primask = 0;
+static uint32_t isr_enter[ISR_COUNT], isr_exit[ISR_COUNT];
+
+uint32_t __get_PRIMASK(void) { return primask; }
+void __set_PRIMASK(uint32_t value) { primask = value; }
+void __disable_irq(void) { primask = 1; }
+
+void IsrStat_Enter(IsrStat_Id_t id, uint32_t latency) { (void)latency; isr_enter[id]++; }
+void IsrStat_Exit(IsrStat_Id_t id, uint32_t cycles) { (void)cycles; isr_exit[id]++; }
+
+/*------------------------------ 总线模型 ------------------------------*/
+static struct {
+    uint8_t  open;              // 起始后、停止前
+    uint8_t  addressed;         // 地址已应答，处于数据阶段
+    uint8_t  dr_full;           // DR 中有待移出的字节
+    uint8_t  dr;
+    uint8_t  shifted;           // 本次传输已移出过数据
+    uint8_t  nack_next;         // 下一次地址不应答
+    uint8_t  dma_tc;            // DMA 传输完成标志
+    uint16_t dma_pos;           // DMA 已搬运的字节数
+    uint8_t  frame[200];        // 当前传输的字节（含地址）
+    uint16_t frame_len;
+    // 统计
+    uint32_t transactions;
+    uint32_t repeated_starts;
+    uint32_t stops;
+    uint32_t cr1_violations;    // STOP/START 未清零时又写 CR1
+} bus;
+
+static uint8_t gddram[8][128];
+static uint8_t ram_page, ram_col;
+
+/**
+  * @brief  SSD1306 页寻址模型：解析一次传输中的控制字节、命令和数据
+  */
+static void Ssd1306_Transaction(const uint8_t *b, uint16_t n)
+{
+    uint16_t i = 1;             // 跳过从机地址
+    while (i < n) {
+        uint8_t ctrl = b[i++];
+        uint8_t co = ctrl & 0x80, dc = ctrl & 0x40;
+        uint16_t end = co ? i + 1 : n;
+        if (end > n) end = n;
+        while (i < end) {
+            uint8_t v = b[i++];
+            if (dc) {
+                gddram[ram_page][ram_col] = v;
+                ram_col = (ram_col + 1) & 127;
+            } else if (v >= 0xB0 && v <= 0xB7) {
+                ram_page = v & 7;
+            } else if (v <= 0x0F) {
+                ram_col = (ram_col & 0xF0) | v;
+            } else if (v >= 0x10 && v <= 0x1F) {
+                ram_col = (uint8_t)(((v & 0x0F) << 4) | (ram_col & 0x0F));
+            } else if (v == 0x81 || v == 0x8D || v == 0xA8 || v == 0xD3 || v == 0xD5 ||
+                       v == 0xD9 || v == 0xDA || v == 0xDB || v == 0x20) {
+                i++;            // 带一个参数的命令
+            }
+        }
+    }
+}
+
+static void Bus_Close(void)
+{
+    if (bus.open) Ssd1306_Transaction(bus.frame, bus.frame_len);
+    bus.open = 0;
+    bus.addressed = 0;
+    bus.frame_len = 0;
+}
+
+static void Bus_Append(uint8_t v)
+{
+    if (bus.frame_len < sizeof(bus.frame)) bus.frame[bus.frame_len++] = v;
+}
+
+/**
+  * @brief  推进一个字节时间
+  */
+static void Bus_Step(void)
+{
+    I2C_TypeDef *i2c = &host_i2c2;
+    DMA_Channel_TypeDef *dma = &host_dma1_channel4;
+
+    if (i2c->CR1 & I2C_CR1_STOP) {
+        i2c->CR1 &= ~I2C_CR1_STOP;
+        Bus_Close();
+        bus.stops++;
+        i2c->SR1 &= ~(I2C_SR1_BTF | I2C_SR1_TXE);
+        return;
+    }
+    if (i2c->CR1 & I2C_CR1_START) {
+        i2c->CR1 &= ~I2C_CR1_START;
+        if (bus.open) bus.repeated_starts++;
+        Bus_Close();
+        bus.open = 1;
+        bus.transactions++;
+        bus.dr_full = 0;
+        bus.shifted = 0;
+        i2c->SR1 = I2C_SR1_SB;
+        return;
+    }
+    if (!bus.addressed) return;
+
+    // 地址阶段结束：中断中读 SR2 清 ADDR，模型在数据开始流动时清除
+    if ((i2c->SR1 & I2C_SR1_ADDR) && ((dma->CCR & DMA_CCR1_EN) || bus.dr_full)) {
+        i2c->SR1 &= ~I2C_SR1_ADDR;
+    }
+    if (bus.dr_full) {
+        Bus_Append(bus.dr);
+        bus.dr_full = 0;
+        bus.shifted = 1;
+    }
+    if ((dma->CCR & DMA_CCR1_EN) && (i2c->CR2 & I2C_CR2_DMAEN) && dma->CNDTR) {
+        CHECK(dma->CMAR == (uint32_t)(uintptr_t)OLED_TxBuf);    // 主机上指针被截断，只核对低 32 位
+        bus.dr = OLED_TxBuf[bus.dma_pos++];
+        bus.dr_full = 1;
+        if (--dma->CNDTR == 0) bus.dma_tc = 1;
+    }
+    if (bus.dr_full) {
+        i2c->SR1 &= ~(I2C_SR1_TXE | I2C_SR1_BTF);
+    } else {
+        i2c->SR1 |= I2C_SR1_TXE;
+        if (bus.shifted) i2c->SR1 |= I2C_SR1_BTF;
+    }
+}
+
+/**
+  * @brief  PRIMASK 打开时按中断使能和标志调用中断函数
+  */
+static void Bus_Irq(void)
+{
+    I2C_TypeDef *i2c = &host_i2c2;
+    if (primask) return;
+    if (bus.dma_tc && (host_dma1_channel4.CCR & DMA_CCR1_TCIE)) {
+        DMA1_Channel4_IRQHandler();
+    }
+    if ((i2c->CR2 & I2C_CR2_ITERREN) && (i2c->SR1 & (I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR))) {
+        I2C2_ER_IRQHandler();
+    }
+    if ((i2c->CR2 & I2C_CR2_ITEVTEN) && (i2c->SR1 & (I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_BTF))) {
+        I2C2_EV_IRQHandler();
+    }
+}
+
+/**
+  * @brief  运行到后台刷新结束且总线空闲
+  * @retval 步数，卡死返回 MAX_STEPS
+  */
+static uint32_t Bus_Run(void)
+{
+    uint32_t steps = 0;
+    while ((OLED_IsBusy() || bus.open || (host_i2c2.CR1 & (I2C_CR1_START | I2C_CR1_STOP))) &&
+           steps < MAX_STEPS) {
+        Bus_Step();
+        Bus_Irq();
+        steps++;
+    }
+    return steps;
+}
+
+/*------------------------------ 库函数（作用于模型） ------------------------------*/
+static void Cr1_Request(I2C_TypeDef *I2Cx, uint16_t bit)
+{
+    if (I2Cx->CR1 & (I2C_CR1_START | I2C_CR1_STOP)) bus.cr1_violations++;
+    I2Cx->CR1 |= bit;
+}
+
+void I2C_DeInit(I2C_TypeDef *I2Cx) { memset((void *)I2Cx, 0, sizeof(*I2Cx)); }
+void I2C_Init(I2C_TypeDef *I2Cx, I2C_InitTypeDef *init) { (void)I2Cx; (void)init; }
+void I2C_Cmd(I2C_TypeDef *I2Cx, FunctionalState s) { if (s) I2Cx->CR1 |= I2C_CR1_PE; }
+
+void I2C_GenerateSTART(I2C_TypeDef *I2Cx, FunctionalState s)
+{
+    if (s) Cr1_Request(I2Cx, I2C_CR1_START);
+    I2Cx->SR1 &= ~I2C_SR1_BTF;
+}
+
+void I2C_GenerateSTOP(I2C_TypeDef *I2Cx, FunctionalState s)
+{
+    if (s) Cr1_Request(I2Cx, I2C_CR1_STOP);
+    I2Cx->SR1 &= ~I2C_SR1_BTF;
+}
+
+void I2C_Send7bitAddress(I2C_TypeDef *I2Cx, uint8_t address, uint8_t direction)
+{
+    (void)direction;
+    CHECK(I2Cx->SR1 & I2C_SR1_SB);
+    I2Cx->SR1 &= ~I2C_SR1_SB;
+    Bus_Append(address);
+    if (bus.nack_next) {
+        bus.nack_next = 0;
+        I2Cx->SR1 |= I2C_SR1_AF;
+        return;
+    }
+    bus.addressed = 1;
+    I2Cx->SR1 |= I2C_SR1_ADDR | I2C_SR1_TXE;
+}
+
+void I2C_SendData(I2C_TypeDef *I2Cx, uint8_t data)
+{
+    bus.dr = data;
+    bus.dr_full = 1;
+    I2Cx->SR1 &= ~(I2C_SR1_TXE | I2C_SR1_BTF);
+}
+
+void I2C_DMACmd(I2C_TypeDef *I2Cx, FunctionalState s)
+{
+    if (s) I2Cx->CR2 |= I2C_CR2_DMAEN; else I2Cx->CR2 &= ~I2C_CR2_DMAEN;
+}
+
+void I2C_ITConfig(I2C_TypeDef *I2Cx, uint16_t it, FunctionalState s)
+{
+    if (s) I2Cx->CR2 |= it; else I2Cx->CR2 &= ~it;
+}
+
+ErrorStatus I2C_CheckEvent(I2C_TypeDef *I2Cx, uint32_t event)
+{
+    uint32_t sr2, flags;
+    Bus_Step();
+    sr2 = bus.open ? (0x0003 | (bus.addressed ? 0x0004 : 0)) : 0;
+    flags = ((uint32_t)sr2 << 16) | I2Cx->SR1;
+    if ((flags & event) != event) return ERROR;
+    if (event & I2C_SR1_ADDR) I2Cx->SR1 &= ~I2C_SR1_ADDR;     // 读 SR1 后读 SR2
+    return SUCCESS;
+}
+
+// BUSY：起始到停止条件之间置位，模型每次查询推进一个字节时间
+FlagStatus I2C_GetFlagStatus(I2C_TypeDef *I2Cx, uint32_t flag)
+{
+    (void)flag;
+    Bus_Step();
+    return (bus.open || (I2Cx->CR1 & (I2C_CR1_START | I2C_CR1_STOP))) ? SET : RESET;
+}
+
+void DMA_DeInit(DMA_Channel_TypeDef *ch) { memset((void *)ch, 0, sizeof(*ch)); }
+void DMA_Init(DMA_Channel_TypeDef *ch, DMA_InitTypeDef *init) { ch->CNDTR = init->DMA_BufferSize; }
+
+void DMA_Cmd(DMA_Channel_TypeDef *ch, FunctionalState s)
+{
+    if (s) {
+        ch->CCR |= DMA_CCR1_EN;
+        bus.dma_pos = 0;
+    } else {
+        ch->CCR &= ~DMA_CCR1_EN;
+    }
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef *ch, uint32_t it, FunctionalState s)
+{
+    if (s) ch->CCR |= it; else ch->CCR &= ~it;
+}
+
+ITStatus DMA_GetITStatus(uint32_t it) { (void)it; return bus.dma_tc ? SET : RESET; }
+void DMA_ClearITPendingBit(uint32_t it) { (void)it; bus.dma_tc = 0; }
+
+/*------------------------------ 测试 ------------------------------*/
+static int Ram_Matches(void)
+{
+    return memcmp(gddram, OLED_DisplayBuf, sizeof(gddram)) == 0;
+}
+
+static void Test_InitAndClear(void)
+{
+    memset(gddram, 0xA5, sizeof(gddram));
+    OLED_Init();                        // 阻塞发送初始化命令，再以 DMA 清屏
+    CHECK(Bus_Run() < MAX_STEPS);
+    CHECK(!OLED_IsBusy());
+    CHECK(Ram_Matches());
+    CHECK(bus.transactions == 1 + 8);   // 初始化命令一次，清屏每页一次
+    CHECK(bus.repeated_starts == 7);    // 页与页之间不停止
+    CHECK(bus.stops == 2);
+}
+
+static void Test_DirtyPagesOnly(void)
+{
+    uint32_t before = bus.transactions;
+    OLED_ShowString(1, 1, "Hi");
+    OLED_ShowString(4, 9, "OK");
+    OLED_Flush();
+    CHECK(OLED_IsBusy());               // 立即返回，由中断接续
+    CHECK(Bus_Run() < MAX_STEPS);
+    CHECK(Ram_Matches());
+    CHECK(bus.transactions - before == 4);
+}
+
+static void Test_FlushWhileBusy(void)
+{
+    OLED_ShowString(2, 1, "A");
+    OLED_Flush();
+    for (int i = 0; i < 5; i++) { Bus_Step(); Bus_Irq(); }
+    OLED_ShowString(1, 3, "B");         // 第 0 页已发过，须由补扫发送
+    OLED_Flush();
+    CHECK(Bus_Run() < MAX_STEPS);
+    CHECK(!OLED_IsBusy());
+    CHECK(Ram_Matches());
+}
+
+static void Test_AddressNack(void)
+{
+    OLED_ShowString(3, 5, "N");
+    bus.nack_next = 1;
+    OLED_Flush();
+    CHECK(Bus_Run() < MAX_STEPS);
+    CHECK(!OLED_IsBusy());
+    CHECK(!Ram_Matches());              // 无应答的页未写入
+    CHECK(OLED_IsDirty());              // 且已重新标脏
+    host_i2c2.SR1 = 0;
+    OLED_Flush();
+    CHECK(Bus_Run() < MAX_STEPS);
+    CHECK(Ram_Matches());
+}
+
+int main(void)
+{
+    Test_InitAndClear();
+    Test_DirtyPagesOnly();
+    Test_FlushWhileBusy();
+    Test_AddressNack();
+
+    CHECK(bus.cr1_violations == 0);
+    CHECK(isr_enter[ISR_OLED] > 0);
+    CHECK(isr_enter[ISR_OLED] == isr_exit[ISR_OLED]);
+
+    printf("%u transactions, %u repeated starts, %u stops, %u OLED interrupts\n",
+           (unsigned)bus.transactions, (unsigned)bus.repeated_starts,
+           (unsigned)bus.stops, (unsigned)isr_enter[ISR_OLED]);
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures != 0;
+}
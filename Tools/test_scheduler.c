@@ -0,0 +1,129 @@
+/*==============================================================================
+  文件：Tools/test_scheduler.c
+  功能：Scheduler 的主机测试（虚拟时间，72MHz）
+        直接包含 System/Scheduler.c，SCHED_CYCLES/SCHED_SLEEP 换成虚拟周期计数：
+        host_sleep 睡到下一个 1ms 节拍并返回睡眠周期数，随后再推进一段“醒来后被抢占”
+        的时间，模拟唤醒中断和更高优先级线程在空闲线程继续执行之前运行。
+        检查：固定速率释放与跳过计数；不同负载下的睡眠占比（输出 CPU 占用率），
+        抢占时间不得计入睡眠
+  编译：gcc -std=gnu99 -Wall -ISystem Tools/test_scheduler.c -o test_scheduler && ./test_scheduler
+==============================================================================*/
+#include <stdio.h>
+#include <stdint.h>
+
+#define TRACE_ENABLE        0
+#define SCHED_CYCLES()      host_cycles()
+#define SCHED_SLEEP()       host_sleep()
+
+static uint32_t host_cycles(void);
+static uint32_t host_sleep(void);
+
+#include "Scheduler.c"
+
+#define CYCLES_PER_MS       72000UL
+
+static uint32_t cycles;                 // 虚拟 DWT 计数
+static uint32_t preempt_cycles;         // 每次唤醒后被中断/高优先级线程占用的周期
+static uint32_t task_cycles[2];         // 两个任务每次运行的耗时
+static int failures = 0;
+
+#define CHECK(cond) do { if (!(cond)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+                                         failures++; } } while (0)
+
+static uint32_t host_cycles(void)
+{
+    return cycles;
+}
+
+static uint32_t now_ms(void)
+{
+    return cycles / CYCLES_PER_MS;
+}
+
+// 睡到下一个 SysTick 节拍；返回后唤醒中断和被 PendSV 切入的线程先运行
+static uint32_t host_sleep(void)
+{
+    uint32_t start = cycles;
+    cycles = (now_ms() + 1) * CYCLES_PER_MS;
+    uint32_t slept = cycles - start;
+    cycles += preempt_cycles;
+    return slept;
+}
+
+static void task_a(void) { cycles += task_cycles[0]; }
+static void task_b(void) { cycles += task_cycles[1]; }
+
+static Sched_Task_t tasks[] = {
+    SCHED_TASK("A", task_a, 20, 0, 0, 5),
+    SCHED_TASK("B", task_b, 100, 5, 1, 50),
+};
+
+/**
+  * @brief  运行界面线程 + 空闲线程的组合：有就绪任务就运行，否则睡到下一个释放时刻
+  * @retval CPU 占用率（‰）
+  */
+static uint16_t Run(uint32_t seconds, uint32_t a_us, uint32_t b_us, uint32_t preempt_us)
+{
+    task_cycles[0] = a_us * 72;
+    task_cycles[1] = b_us * 72;
+    preempt_cycles = preempt_us * 72;
+    Sched_Init(tasks, 2, now_ms());
+
+    uint32_t end = cycles + seconds * 1000 * CYCLES_PER_MS;
+    while ((int32_t)(cycles - end) < 0) {
+        if (Sched_Run(now_ms())) continue;
+        uint32_t next = Sched_NextRelease();
+        while ((int32_t)(now_ms() - next) < 0) Sched_Sleep();
+    }
+    return (uint16_t)(1000 - Sched_GetSleepPermille());
+}
+
+static int count_a, count_b;
+static void count_fa(void) { count_a++; }
+static void count_fb(void) { count_b++; }
+
+static void Test_FixedRate(void)
+{
+    static Sched_Task_t t[] = {
+        SCHED_TASK("A", count_fa, 20, 0, 0, 5),
+        SCHED_TASK("B", count_fb, 100, 5, 1, 50),
+    };
+
+    Sched_Init(t, 2, 1000);
+    for (uint32_t now = 1000; now < 2000; now++) {
+        while (Sched_Run(now));
+    }
+    CHECK(count_a == 50 && count_b == 10);
+    CHECK(Sched_NextRelease() == 2000);
+
+    // 75ms 才再次运行：20ms 的释放迟到运行一次（超时），40、60 两次跳过，不连续补跑
+    Sched_Init(t, 2, 0);
+    count_a = 0;
+    Sched_Run(0);
+    Sched_Run(75);
+    CHECK(count_a == 2 && t[0].skips == 2 && t[0].next_release == 80);
+    CHECK(t[0].misses == 1);
+}
+
+static void Test_Load(const char *name, uint32_t a_us, uint32_t b_us, uint32_t preempt_us,
+                      uint16_t expected)
+{
+    uint16_t load = Run(3, a_us, b_us, preempt_us);
+    printf("%-28s CPU %3u.%u%%  (expected ~%u.%u%%)\n", name,
+           load / 10, load % 10, expected / 10, expected % 10);
+    CHECK(load + 10 >= expected && load <= expected + 10);
+}
+
+int main(void)
+{
+    Test_FixedRate();
+
+    Test_Load("idle", 0, 0, 0, 0);
+    Test_Load("tasks 10% + 10%", 2000, 10000, 0, 200);
+    Test_Load("preempted 300us per tick", 0, 0, 300, 300);
+    Test_Load("tasks + preempted", 2000, 10000, 300, 440);
+    Test_Load("busy low thread 950us/tick", 0, 0, 950, 950);
+
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures != 0;
+}
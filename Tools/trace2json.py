@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+把串口导出的跟踪记录（System/Trace.c 的 Trace_Dump 输出）转换为
+Chrome about:tracing / Perfetto (ui.perfetto.dev) 可打开的 JSON。
+
+串口 115200 8N1 接 PB10(TX)/PB11(RX)，发送 'd' 后把终端输出保存为文本，
+文本中可以夹杂其他内容，只解析 TRACE ... END 之间的行；有多次导出时默认取最后一次。
+
+用法（在工程根目录）：
+    python Tools/trace2json.py capture.txt                 # 输出 capture.json
+    python Tools/trace2json.py capture.txt -o trace.json --all
+名称表需与 System/Trace.h、System/IsrStat.h、User/main.c 中的定义保持一致。
+"""
+import argparse
+import json
+import os
+import re
+import sys
+
+# System/Trace.h Trace_Id_t
+EVENT_NAMES = {
+    1: "ISR", 2: "Switch", 3: "Task", 4: "Control", 5: "LDR", 6: "DHT11",
+    7: "Ultrasonic", 8: "Flash", 9: "OLED flush",
+}
+# System/IsrStat.h IsrStat_Id_t
+ISR_NAMES = ["SysTick", "TIM3", "TIM1", "DHT11", "EXTI9_5", "OLED"]
+# User/main.c 界面线程任务表顺序
+TASK_NAMES = ["INPT", "DISP", "STAT", "CHRT", "LOAD"]
+# User/main.c 线程优先级
+THREAD_NAMES = {0: "CTRL", 1: "UI", 2: "SAVE", 3: "SENS", 4: "IDLE",
+                0xFE: "main", 0xFF: "ISR"}
+
+EVENT_ISR, EVENT_SWITCH, EVENT_TASK = 1, 2, 3
+PHASE_MARK, PHASE_BEGIN, PHASE_END = 0, 1, 2
+
+HEADER = re.compile(r"^TRACE ([0-9A-F]{2}) ([0-9A-F]{4}) ([0-9A-F]{8})$")
+RECORD = re.compile(r"^([0-9A-F]{8}) ([0-9A-F]{2}) ([0-9A-F]{2}) ([0-9A-F]{4})$")
+
+
+def parse_dumps(lines):
+    """返回 [(每微秒周期数, 记录总数, [(time, id, ctx, arg), ...]), ...]"""
+    dumps = []
+    current = None
+    for line in lines:
+        line = line.strip()
+        m = HEADER.match(line)
+        if m:
+            current = (int(m.group(1), 16), int(m.group(3), 16), [])
+            continue
+        if current is None:
+            continue
+        if line == "END":
+            dumps.append(current)
+            current = None
+            continue
+        m = RECORD.match(line)
+        if m:
+            current[2].append(tuple(int(g, 16) for g in m.groups()))
+    return dumps
+
+
+def unwrap(records):
+    """32 位周期计数展开为单调 64 位；相邻记录可能轻微乱序，按有符号差值展开后排序"""
+    out = []
+    prev_raw = None
+    t = 0
+    for time, ident, ctx, arg in records:
+        if prev_raw is not None:
+            delta = (time - prev_raw) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            t += delta
+        prev_raw = time
+        out.append((t, ident, ctx, arg))
+    out.sort(key=lambda r: r[0])
+    return out
+
+
+def event_name(event, arg):
+    if event == EVENT_ISR:
+        return ISR_NAMES[arg] if arg < len(ISR_NAMES) else "ISR %d" % arg
+    if event == EVENT_TASK:
+        return TASK_NAMES[arg] if arg < len(TASK_NAMES) else "Task %d" % arg
+    return EVENT_NAMES.get(event, "Event %d" % event)
+
+
+def convert(cycles_per_us, records, base_us=0.0):
+    """生成 traceEvents；缓冲区开头缺 B 的 E 丢弃，结尾未结束的 B 补 E"""
+    events = []
+    records = unwrap(records)
+    if not records:
+        return events, base_us
+    t0 = records[0][0]
+    stacks = {}
+    last_us = base_us
+    for t, ident, ctx, arg in records:
+        phase, event = ident >> 6, ident & 0x3F
+        ts = round(base_us + (t - t0) / float(cycles_per_us), 3)
+        last_us = ts
+        stack = stacks.setdefault(ctx, [])
+        # 区段名称由开始记录决定（ISR、任务的 arg 为编号，其他事件的结束 arg 为结果）
+        if phase == PHASE_BEGIN:
+            name = event_name(event, arg)
+            stack.append((event, name))
+            events.append({"name": name, "ph": "B", "ts": ts, "pid": 1, "tid": ctx,
+                           "args": {"arg": arg}})
+        elif phase == PHASE_END:
+            if not stack or stack[-1][0] != event:
+                continue
+            name = stack.pop()[1]
+            events.append({"name": name, "ph": "E", "ts": ts, "pid": 1, "tid": ctx,
+                           "args": {"result": arg}})
+        else:
+            name = event_name(event, arg)
+            if event == EVENT_SWITCH:
+                name = "-> " + THREAD_NAMES.get(arg, str(arg))
+            events.append({"name": name, "ph": "i", "s": "t", "ts": ts, "pid": 1,
+                           "tid": ctx, "args": {"arg": arg}})
+    for ctx, stack in stacks.items():
+        while stack:
+            events.append({"name": stack.pop()[1], "ph": "E", "ts": last_us,
+                           "pid": 1, "tid": ctx})
+    return events, last_us
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Trace_Dump 串口输出转 Chrome/Perfetto JSON")
+    parser.add_argument("capture", help="串口终端保存的文本")
+    parser.add_argument("-o", "--output", help="输出 JSON，默认与输入同名")
+    parser.add_argument("--all", action="store_true", help="转换所有导出，依次排在时间轴上")
+    args = parser.parse_args()
+
+    with open(args.capture, "r", errors="replace") as f:
+        dumps = parse_dumps(f)
+    if not dumps:
+        sys.exit("未找到 TRACE ... END 导出")
+    if not args.all:
+        dumps = dumps[-1:]
+
+    events = []
+    used = set()
+    base_us = 0.0
+    for cycles_per_us, total, records in dumps:
+        if total > len(records):
+            print("提示：%d 条记录中最旧的 %d 条已被覆盖" % (total, total - len(records)))
+        part, base_us = convert(cycles_per_us, records, base_us)
+        base_us += 1000.0                   # 多次导出之间留 1ms 间隔
+        events.extend(part)
+        used.update(e["tid"] for e in part)
+
+    events.append({"name": "process_name", "ph": "M", "pid": 1,
+                   "args": {"name": "STM32F103"}})
+    for tid in sorted(used):
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                       "args": {"name": THREAD_NAMES.get(tid, "ctx %d" % tid)}})
+        # 按优先级排列，中断在最上方
+        events.append({"name": "thread_sort_index", "ph": "M", "pid": 1, "tid": tid,
+                       "args": {"sort_index": -1 if tid == 0xFF else tid}})
+
+    output = args.output or os.path.splitext(args.capture)[0] + ".json"
+    with open(output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, f)
+    print("%d 条事件写入 %s" % (len(events), output))
+
+
+if __name__ == "__main__":
+    main()
@@ -3,9 +3,7 @@
 ==============================================================================*/
 #include "stm32f10x.h"
 #include "system_stm32f10x.h"
-#include <stdio.h>
 #include <math.h>
-#include <string.h>
 
 #include "Delay.h"
 #include "OLED.h"
@@ -18,267 +16,407 @@
 #include "LightControl.h"
 #include "Config.h"
 #include "KeyEXTI.h"
+#include "Format.h"
+#include "Screen.h"
+#include "Chart.h"
+#include "Overlay.h"
+#include "Scheduler.h"
+#include "Timebase.h"
+#include "Kernel.h"
+#include "Event.h"
+#include "Jitter.h"
+#include "Diag.h"
+#include "Prof.h"
+#include "IrqPrio.h"
+#include "IsrStat.h"
+#include "Trace.h"
+#include "EchoFilter.h"
 
 // wrapper 声明
 uint32_t CountSensor_GetSpeed(uint16_t c, uint32_t dt_ms, uint32_t pd_cm);
-uint8_t  DHT11_Read(uint8_t *t, uint8_t *h);
 uint8_t  LDR_GetPercent(void);
 void     LED1_Toggle(void);
-float    Ultrasonic_GetDistance(void);
 
 // 模式定义
 #define MODE_AUTO    0
 #define MODE_MANUAL  1
 #define MODE_CONFIG  2
 
-// 刷新间隔
-#define SAMPLE_INTERVAL_MS  100   // 传感器采样周期
+// 显示页面（KEY3长按切换）
+#define DISPLAY_PAGE_NUMERIC  0   // 数值界面
+#define DISPLAY_PAGE_CHART    1   // 历史曲线
+#define DISPLAY_PAGE_LOAD     2   // CPU 负载与各环节耗时
+#define DISPLAY_PAGE_DIAG     3   // 诊断页起始，之后依次为 Diag 的各个视图
+#define DISPLAY_PAGE_COUNT    (DISPLAY_PAGE_DIAG + DIAG_VIEW_COUNT)
+
+// 任务周期
+#define CONTROL_PERIOD_MS   20    // 灯光控制周期（固定速率，控制线程）
+#define CONTROL_DEADLINE_US 5000  // 释放到灯光输出更新完成的截止时间
+#define SAMPLE_INTERVAL_MS  100   // 传感器采样周期（传感器线程）
+#define INPUT_PERIOD_MS     20    // 按键与提示处理周期
 #define DISPLAY_UPDATE_MS   200   // 显示更新周期
-#define IDLE_LOOP_MS        20    // 主循环空闲时间
+#define STATUS_PERIOD_MS    50    // 状态LED检查周期
+#define CHART_PERIOD_MS     100   // 曲线采样周期
+#define LOAD_PERIOD_MS      1000  // 负载统计周期（与睡眠统计窗口一致）
+#define LOAD_TEST_BUSY_MS   0     // 负载页自检：传感器线程每周期额外忙等的毫秒数，CPU 应增加约 N*10%
+#define DISPLAY_SLICE_BYTES 32    // 空闲时每次推送的显存字节数（400kHz 约0.8ms）
 
 // 车速计算参数
 #define WHEEL_CIRCUMFERENCE_CM  20.0f  // 车轮周长
 #define PULSES_PER_ROTATION     20     // 码盘一圈脉冲数
 #define ZERO_SPEED_TIMEOUT_MS   200    // 200ms无脉冲认为停止
 
-static char     buf[20];
 static uint32_t spd;
-static uint8_t  lp, tp, hp;
-static float    ds;
-
-// 车速计算相关变量
-static uint16_t last_pulse_count = 0;
-static uint32_t last_calc_time = 0;
-
-// 显示缓冲区
-typedef struct {
-    uint32_t speed;
-    uint8_t  light;
-    float    distance;
-    uint8_t  temperature;
-    uint8_t  humidity;
-    uint8_t  mode;
-    uint8_t  valid;
-} DisplayBuffer_t;
-
-static DisplayBuffer_t display_buffer = {0};
-
-// --- OLED防闪烁行缓冲（修正单位丢失核心） ---
-static char line_buffers[5][17] = {0};  // 每行最多16个字符 + '\0'
-
-// 清空行缓冲
-void Clear_LineBuffers(void) {
-    for (int i = 0; i < 5; i++) {
-        memset(line_buffers[i], 0, sizeof(line_buffers[i]));
+static uint8_t  lp;
+static DHT11_Sample_t climate;         // 温湿度缓存副本，控制线程独占，每周期更新
+static DHT11_Sample_t climate_view;    // 界面线程的副本，绘制前整体复制，字段之间一致
+static float    ds;                     // 滤波后的距离 cm，负数表示前方无障碍
+static EchoFilter_t echo_filter;        // 控制线程独占
+static uint8_t  disp_mode;
+static uint8_t  display_page = DISPLAY_PAGE_NUMERIC;
+
+// 负载页数据
+static uint8_t  cpu_load;                // 最近 1s 忙碌时间占比 %
+static uint32_t loop_hz;                 // 控制循环实际频率
+static uint32_t flush_us;                // 最近一帧显存推送占用的 CPU 时间
+static uint32_t ldr_read_us;            // 最近一次光照采集耗时
+static uint32_t echo_hz;                 // 超声实际测距频率（TIM1 硬件触发）
+
+// 线程：优先级数值越小越高；空闲线程必须最低且永不阻塞
+#define PRIO_CONTROL   0
+#define PRIO_UI        1
+#define PRIO_PERSIST   2
+#define PRIO_SENSORS   3
+#define PRIO_IDLE      4
+
+static Kernel_Thread_t thread_control, thread_ui, thread_persist, thread_sensors, thread_idle;
+static uint64_t stack_control[512 / 8];
+static uint64_t stack_ui[1024 / 8];
+static uint64_t stack_persist[512 / 8];
+static uint64_t stack_sensors[512 / 8];
+static uint64_t stack_idle[256 / 8];
+
+// 保存请求与结果：结果编码为 (来源 << 8) | 是否成功
+#define SAVE_QUEUE_SIZE  4
+static Kernel_Sem_t   save_sem;
+static volatile uint8_t save_source;
+static Kernel_Queue_t save_result_queue;
+static uint32_t       save_result_buffer[SAVE_QUEUE_SIZE];
+
+// 按键事件由控制线程从 Event 队列取出后转发给界面线程：(类型 << 8) | 按键号
+#define KEY_QUEUE_SIZE   8
+static Kernel_Queue_t key_queue;
+static uint32_t       key_buffer[KEY_QUEUE_SIZE];
+
+// 车速计算相关变量（控制线程取出码盘事件后更新）
+static uint16_t wheel_pulses = 0;        // 上次计算以来的脉冲数
+static uint32_t wheel_time = 0;          // 最近一个脉冲的时间戳（us）
+static uint32_t last_pulse_time = 0;     // 上次计算时最后一个脉冲的时间戳（us）
+
+// --- 主界面字段格式化 ---
+static uint8_t Fmt_Speed(char *buf, const void *src)
+{
+    return Format_UInt(buf, *(const uint32_t *)src, 3);
+}
+
+static uint8_t Fmt_Percent(char *buf, const void *src)
+{
+    return Format_UInt(buf, *(const uint8_t *)src, 3);
+}
+
+static uint8_t Fmt_Distance(char *buf, const void *src)
+{
+    float d = *(const float *)src;
+    if (d < 0) return Format_Invalid(buf, 4);
+    return Format_Tenths(buf, (int32_t)(d * 10.0f + 0.5f), 4);
+}
+
+// 温湿度：缓存失效（传感器长时间读取失败）时显示 --
+static uint8_t Fmt_Temperature(char *buf, const void *src)
+{
+    const DHT11_Sample_t *s = (const DHT11_Sample_t *)src;
+    if (!s->valid) return Format_Str(buf, "--");
+    return Format_UInt(buf, s->temperature, 2);
+}
+
+static uint8_t Fmt_Humidity(char *buf, const void *src)
+{
+    const DHT11_Sample_t *s = (const DHT11_Sample_t *)src;
+    if (!s->valid) return Format_Str(buf, "--");
+    return Format_UInt(buf, s->humidity, 2);
+}
+
+static uint8_t Fmt_Mode(char *buf, const void *src)
+{
+    switch (*(const uint8_t *)src) {
+        case MODE_AUTO:   return Format_Str(buf, "A");
+        case MODE_MANUAL: return Format_Str(buf, "M");
+        default:          return Format_Str(buf, " ");
     }
 }
 
-// 安全写入字符串到OLED（含单位修正）
-void Safe_OLED_ShowString(uint8_t line, uint8_t column, char* str, uint8_t max_len)
+// 微秒显示为毫秒，一位小数
+static uint8_t Fmt_UsTenths(char *buf, const void *src)
 {
-    if (line == 0 || line > 4 || column == 0 || column > 16) return;
+    return Format_Tenths(buf, (*(const uint32_t *)src + 50) / 100, 5);
+}
 
-    uint8_t start_pos = column - 1;
-    uint8_t str_len = strlen(str);
-    if (str_len > max_len) str_len = max_len;
+// 微秒显示为整数毫秒
+static uint8_t Fmt_UsMs(char *buf, const void *src)
+{
+    return Format_UInt(buf, (*(const uint32_t *)src + 500) / 1000, 3);
+}
 
-    uint8_t need_update = 0;
-    for (uint8_t i = 0; i < str_len; i++) {
-        if (start_pos + i >= 16) break;
-        if (line_buffers[line][start_pos + i] != str[i]) {
-            need_update = 1;
-            break;
-        }
+static uint8_t Fmt_Hz(char *buf, const void *src)
+{
+    return Format_UInt(buf, *(const uint32_t *)src, 3);
+}
+
+// 温湿度缓存距最近一次成功读取的秒数，从未成功显示 ---
+static uint8_t Fmt_ClimateAge(char *buf, const void *src)
+{
+    const DHT11_Sample_t *s = (const DHT11_Sample_t *)src;
+    uint32_t age;
+    if (s->time_ms == 0) return Format_Str(buf, "---");
+    age = (Time_Ms() - s->time_ms) / 1000;
+    return Format_UInt(buf, age > 999 ? 999 : age, 3);
+}
+
+static uint8_t Fmt_Failures(char *buf, const void *src)
+{
+    uint8_t n = *(const uint8_t *)src;
+    return Format_UInt(buf, n > 99 ? 99 : n, 2);
+}
+
+// 主界面：位置、宽度、格式化函数、数据源、单位
+static const ScreenField_t mainScreen[] = {
+    {1,  1, 0, 0,             "Spd:", 0     },
+    {1,  5, 4, Fmt_Speed,     &spd,   "cm/s"},
+    {1, 15, 1, Fmt_Mode,      &disp_mode, 0 },
+    {2,  1, 0, 0,             "Lux:", 0     },
+    {2,  5, 4, Fmt_Percent,   &lp,    "%"   },
+    {3,  1, 0, 0,             "Dst:", 0     },
+    {3,  5, 5, Fmt_Distance,  &ds,    "cm"  },
+    {4,  1, 0, 0,             "T:",   0     },
+    {4,  3, 3, Fmt_Temperature, &climate_view, "C" },
+    {4,  8, 0, 0,             "H:",   0     },
+    {4, 10, 3, Fmt_Humidity,  &climate_view, "%" },
+};
+
+// 负载页：CPU 忙碌占比、控制循环频率、显存推送耗时、温湿度缓存年龄（s）、光照采集耗时、
+// 超声测距频率、温湿度连续失败次数
+// 用于判断响应慢是 CPU 不足、总线（OLED）还是传感器等待造成
+static const ScreenField_t loadScreen[] = {
+    {1,  1, 0, 0,            "CPU:",  0     },
+    {1,  5, 3, Fmt_Percent,  &cpu_load, "%" },
+    {1, 11, 3, Fmt_Hz,       &loop_hz,  "Hz"},
+    {2,  1, 0, 0,            "OLED:", 0     },
+    {2,  6, 5, Fmt_UsTenths, &flush_us, "ms"},
+    {3,  1, 0, 0,            "DHT",   0     },
+    {3,  4, 3, Fmt_ClimateAge, &climate_view, "s"},
+    {3, 10, 0, 0,            "LD",    0     },
+    {3, 12, 3, Fmt_UsMs,     &ldr_read_us, "ms"},
+    {4,  1, 0, 0,            "Sonar:", 0    },
+    {4,  7, 3, Fmt_Hz,       &echo_hz,  "Hz"},
+    {4, 13, 0, 0,            "F:",    0     },
+    {4, 15, 2, Fmt_Failures, &climate_view.failures, 0},
+};
+
+// OLED当前页面整屏重画（其他页面/提示覆盖屏幕后调用；提示显示期间推迟到提示结束）
+void Redraw_OLED_Labels(void)
+{
+    if (Overlay_IsActive()) return;
+
+    disp_mode = LightControl_GetMode();
+    if (disp_mode == MODE_CONFIG) {
+        first_entry_flag = 1;   // 由配置界面自行重画
+        return;
     }
-    for (uint8_t i = str_len; i < max_len && start_pos + i < 16; i++) {
-        if (line_buffers[line][start_pos + i] != ' ' && line_buffers[line][start_pos + i] != '\0') {
-            need_update = 1;
-            break;
-        }
+    if (display_page == DISPLAY_PAGE_CHART) {
+        Chart_Redraw();
+        return;
     }
-    if (need_update) {
-        for (uint8_t i = 0; i < max_len && start_pos + i < 16; i++) {
-            if (i < str_len) {
-                line_buffers[line][start_pos + i] = str[i];
-            } else {
-                line_buffers[line][start_pos + i] = ' ';
-            }
-        }
-        OLED_ShowString(line, column, str);
-        for (uint8_t i = str_len; i < max_len; i++) {
-            OLED_ShowChar(line, column + i, ' ');
-        }
+    if (display_page >= DISPLAY_PAGE_DIAG) {
+        Diag_Redraw(display_page - DISPLAY_PAGE_DIAG);
+        return;
     }
+    DHT11_GetSample(&climate_view);
+    if (display_page == DISPLAY_PAGE_LOAD) {
+        Screen_Clear();
+        Screen_Render(loadScreen, SCREEN_FIELD_COUNT(loadScreen));
+        return;
+    }
+    Screen_Clear();
+    Screen_Render(mainScreen, SCREEN_FIELD_COUNT(mainScreen));
 }
 
-// OLED主标签重绘，并重置缓冲
-void Redraw_OLED_Labels(void)
+// 切换到下一个显示页面
+void Display_NextPage(void)
 {
-    OLED_ShowString(1, 1, "Spd:");
-    OLED_ShowString(2, 1, "Lux:");
-    OLED_ShowString(3, 1, "Dst:");
-    OLED_ShowString(4, 1, "T:");
-    OLED_ShowString(4, 8, "H:");
-    Clear_LineBuffers();
-    display_buffer.valid = 0;
+    display_page = (display_page + 1) % DISPLAY_PAGE_COUNT;
+    Redraw_OLED_Labels();
 }
 
-// 车速计算
-uint32_t Calculate_Real_Speed(void)
+// 清零当前诊断页的统计（界面线程按键处理调用），非诊断页或该视图无统计时不处理
+void Display_ResetStats(void)
+{
+    if (display_page >= DISPLAY_PAGE_DIAG && Diag_Reset(display_page - DISPLAY_PAGE_DIAG)) {
+        Overlay_Show(2, 3, "STATS RESET", 500);
+    }
+}
+
+// 取出所有事件：码盘、超声、光照在控制线程内使用，按键事件转发给界面线程
+static void Control_DrainEvents(void)
 {
-    uint32_t current_time = GetTick();
-    uint16_t current_pulses = CountSensor_Get();
+    Event_t ev;
+    while (Event_Get(&ev)) {
+        switch (ev.type) {
+            case EVENT_WHEEL:
+                wheel_pulses += ev.value;
+                wheel_time = ev.time_us;
+                break;
+            case EVENT_ECHO:
+                EchoFilter_Add(&echo_filter, ev.value, ev.time_us);
+                break;
+            case EVENT_ADC:
+                lp = (uint8_t)ev.value;
+                break;
+            default:
+                Kernel_QueuePut(&key_queue, ((uint32_t)ev.type << 8) | ev.arg);
+                break;
+        }
+    }
 
-    uint32_t time_delta = current_time - last_calc_time;
-    uint16_t pulse_delta = 0;
+    // 距离取滤波输出；长时间没有与输出一致的样本时同样按无障碍处理
+    uint16_t distance = EchoFilter_Distance(&echo_filter, Time_Us());
+    ds = (distance == ECHO_FILTER_NONE) ? -1.0f : distance / 10.0f;
 
-    if (current_pulses >= last_pulse_count) {
-        pulse_delta = current_pulses - last_pulse_count;
-    } else {
-        pulse_delta = (10000 - last_pulse_count) + current_pulses;
+    // 温湿度取缓存；有新的成功读取时超声按当前气温的声速换算距离
+    uint32_t climate_time = climate.time_ms;
+    DHT11_GetSample(&climate);
+    if (climate.valid && climate.time_ms != climate_time) {
+        Ultrasonic_SetTemperature(climate.temperature);
     }
-    uint32_t speed = 0;
-
-    if (pulse_delta > 0 && time_delta > 0) {
-        float rotations = (float)pulse_delta / PULSES_PER_ROTATION;
-        float distance_cm = rotations * WHEEL_CIRCUMFERENCE_CM;
-        float calculated_speed = (distance_cm * 1000.0f) / time_delta;
-        if (calculated_speed > 200.0f) calculated_speed = 200.0f;
-        if (calculated_speed < 0.0f) calculated_speed = 0.0f;
-        speed = (uint32_t)calculated_speed;
-    } else {
-        if (time_delta > ZERO_SPEED_TIMEOUT_MS) {
-            speed = 0;
-        } else {
-            return spd;
+}
+
+// 车速计算：用码盘脉冲事件的时间戳（us）计算，不受调用时刻抖动影响
+uint32_t Calculate_Real_Speed(void)
+{
+    if (wheel_pulses == 0) {
+        // 长时间无脉冲认为停止
+        if (Time_Us() - last_pulse_time > ZERO_SPEED_TIMEOUT_MS * 1000UL) {
+            return 0;
         }
+        return spd;
     }
-    last_pulse_count = current_pulses;
-    last_calc_time = current_time;
-    return speed;
+
+    // 上次计算时的最后一个脉冲到本次最后一个脉冲之间走过 pulse_delta 个脉冲
+    uint16_t pulse_delta = wheel_pulses;
+    uint32_t time_delta = wheel_time - last_pulse_time;
+    wheel_pulses = 0;
+    last_pulse_time = wheel_time;
+
+    // 停止后重新起步：间隔包含停车时间，本次只重新定基准
+    if (time_delta == 0 || time_delta > ZERO_SPEED_TIMEOUT_MS * 1000UL) {
+        return 0;
+    }
+
+    float distance_cm = (float)pulse_delta * WHEEL_CIRCUMFERENCE_CM / PULSES_PER_ROTATION;
+    float calculated_speed = distance_cm * 1000000.0f / time_delta;
+    if (calculated_speed > 200.0f) calculated_speed = 200.0f;
+    return (uint32_t)calculated_speed;
 }
 
-// 读取所有传感器
+// 读取所有传感器（传感器线程）
+// 光照以事件交给控制线程；DHT11 按自身转换周期（失败时退避）启动读取，结果进入驱动缓存；
+// 距离由超声捕获中断直接投递事件
 void Read_AllSensors(void)
 {
-    lp  = LDR_GetPercent();
-    DHT11_Read(&tp, &hp);
-    ds  = Ultrasonic_GetDistance();
+    uint32_t t0 = Time_Us();
+    uint8_t light = LDR_GetPercent();
+
+    ldr_read_us = Time_Us() - t0;
+    DHT11_Poll(0);
+    Event_Post(EVENT_ADC, 0, light);
 }
 
-// OLED主数据刷新（修正切换后不刷新bug/单位丢失）
-void Update_Display(void)
+// 请求保存参数：由存储线程写 Flash，调用方不等待
+void Persist_RequestSave(uint8_t source)
 {
-    static uint8_t last_mode = 0xFF;
-    uint8_t mode = LightControl_GetMode();
-
-    // 模式切换时，必须全部重画并刷新所有数据
-    if (mode != last_mode && mode != MODE_CONFIG) {
-        OLED_Clear();
-        Delay_ms(20);
-        Redraw_OLED_Labels();
-        last_mode = mode;
-        display_buffer.valid = 0;
-
-        // 强制刷新全部内容（含单位！）
-        sprintf(buf, "%3lu", (unsigned long)spd);
-        Safe_OLED_ShowString(1, 5, buf, 4);
-        Safe_OLED_ShowString(1, 9, "cm/s", 4);
-
-        sprintf(buf, "%3d", lp);
-        Safe_OLED_ShowString(2, 5, buf, 3);
-        Safe_OLED_ShowString(2, 9, "%", 1);
+    save_source = source;
+    Kernel_SemPost(&save_sem);
+}
 
-        if (ds >= 0) {
-            sprintf(buf, "%4.1f", ds);
+// 显示存储线程返回的保存结果
+static void Show_SaveResults(void)
+{
+    uint32_t msg;
+    while (Kernel_QueueGet(&save_result_queue, &msg, KERNEL_NO_WAIT)) {
+        uint8_t ok = msg & 0xFF;
+        if ((msg >> 8) == SAVE_SOURCE_AUTO) {
+            Overlay_Show(3, 1, ok ? "AUTO SAVE OK" : "AUTO SAVE FAIL", 1000);
         } else {
-            sprintf(buf, "----");
+            if (ok) Overlay_Show(2, 5, "SAVE OK", 1000);
+            else    Overlay_Show(2, 4, "SAVE FAIL", 1000);
+            Overlay_Show(2, 4, "AUTO MODE", 500);
         }
-        Safe_OLED_ShowString(3, 5, buf, 5);
-        Safe_OLED_ShowString(3, 10, "cm", 2);
+    }
+}
 
-        sprintf(buf, "%2d", tp);
-        Safe_OLED_ShowString(4, 3, buf, 2);
-        Safe_OLED_ShowString(4, 6, "C", 1);
+// OLED主数据刷新：按字段表渲染，只有变化的字符写入显存
+void Update_Display(void)
+{
+    static uint8_t last_mode = 0xFF;
+    uint8_t mode = LightControl_GetMode();
 
-        sprintf(buf, "%2d", hp);
-        Safe_OLED_ShowString(4, 10, buf, 2);
-        Safe_OLED_ShowString(4, 13, "%", 1);
+    // 提示显示期间不绘制，提示结束后由Overlay调用Redraw_OLED_Labels
+    if (Overlay_IsActive()) return;
 
-        switch (mode) {
-            case MODE_AUTO:   Safe_OLED_ShowString(1, 15, "A", 1); break;
-            case MODE_MANUAL: Safe_OLED_ShowString(1, 15, "M", 1); break;
-            default:          Safe_OLED_ShowString(1, 15, " ", 1); break;
-        }
-        // 更新缓冲区内容
-        display_buffer.speed = spd;
-        display_buffer.light = lp;
-        display_buffer.distance = ds;
-        display_buffer.temperature = tp;
-        display_buffer.humidity = hp;
-        display_buffer.mode = mode;
-        display_buffer.valid = 1;
+    if (mode == MODE_CONFIG) {
+        last_mode = mode;
         return;
     }
+    PROF_BEGIN(PROF_UPDATE_DISPLAY);
+    disp_mode = mode;
+    DHT11_GetSample(&climate_view);
+    if (mode != last_mode) {
+        // 从配置界面返回或模式切换时整屏重画
+        last_mode = mode;
+        Redraw_OLED_Labels();
+    } else if (display_page == DISPLAY_PAGE_NUMERIC) {
+        Screen_Render(mainScreen, SCREEN_FIELD_COUNT(mainScreen));
+    } else if (display_page == DISPLAY_PAGE_LOAD) {
+        Screen_Render(loadScreen, SCREEN_FIELD_COUNT(loadScreen));
+    } else if (display_page >= DISPLAY_PAGE_DIAG) {
+        Diag_Update(display_page - DISPLAY_PAGE_DIAG);
+    }
+    PROF_END(PROF_UPDATE_DISPLAY);
+}
 
-    // 非配置模式时自动刷新主界面
-    if (mode != MODE_CONFIG) {
-        uint8_t need_update = 0;
-        if (!display_buffer.valid ||
-            display_buffer.speed != spd ||
-            display_buffer.light != lp ||
-            display_buffer.distance != ds ||
-            display_buffer.temperature != tp ||
-            display_buffer.humidity != hp ||
-            display_buffer.mode != mode) {
-            need_update = 1;
-        }
-        if (need_update) {
-            sprintf(buf, "%3lu", (unsigned long)spd);
-            Safe_OLED_ShowString(1, 5, buf, 4);
-            Safe_OLED_ShowString(1, 9, "cm/s", 4);
-
-            sprintf(buf, "%3d", lp);
-            Safe_OLED_ShowString(2, 5, buf, 3);
-            Safe_OLED_ShowString(2, 9, "%", 1);
-
-            if (ds >= 0) {
-                sprintf(buf, "%4.1f", ds);
-            } else {
-                sprintf(buf, "----");
-            }
-            Safe_OLED_ShowString(3, 5, buf, 5);
-            Safe_OLED_ShowString(3, 10, "cm", 2);
-
-            sprintf(buf, "%2d", tp);
-            Safe_OLED_ShowString(4, 3, buf, 2);
-            Safe_OLED_ShowString(4, 6, "C", 1);
-
-            sprintf(buf, "%2d", hp);
-            Safe_OLED_ShowString(4, 10, buf, 2);
-            Safe_OLED_ShowString(4, 13, "%", 1);
-
-            switch (mode) {
-                case MODE_AUTO:   Safe_OLED_ShowString(1, 15, "A", 1); break;
-                case MODE_MANUAL: Safe_OLED_ShowString(1, 15, "M", 1); break;
-                default:          Safe_OLED_ShowString(1, 15, " ", 1); break;
-            }
-            display_buffer.speed = spd;
-            display_buffer.light = lp;
-            display_buffer.distance = ds;
-            display_buffer.temperature = tp;
-            display_buffer.humidity = hp;
-            display_buffer.mode = mode;
-            display_buffer.valid = 1;
+// 空闲处理：分片推送显存，之后睡眠到下一个任务释放；控制路径不等待屏幕
+void Display_Idle(uint32_t deadline)
+{
+    static uint32_t frame_us = 0;   // 当前帧已累计的推送时间
+
+    while (!Time_ReachedMs(deadline) && OLED_IsDirty()) {
+        uint32_t start = Time_Us();
+        uint8_t more = OLED_FlushStep(DISPLAY_SLICE_BYTES);
+        frame_us += Time_Us() - start;
+        if (!more) {
+            flush_us = frame_us;    // 一帧推送完成
+            frame_us = 0;
+            break;
         }
     }
+    // 剩余时间让出CPU，到期由内核唤醒
+    Kernel_SleepUntil(deadline);
 }
 
 // 系统状态LED
 void Update_SystemStatus(void)
 {
     static uint32_t last_led = 0;
-    uint32_t now = GetTick();
+    uint32_t now = Time_Ms();
     uint16_t interval;
     switch (LightControl_GetMode()) {
         case MODE_AUTO:   interval = 1000; break;
@@ -292,14 +430,136 @@ void Update_SystemStatus(void)
     }
 }
 
-int main(void)
+// --- 界面线程内的调度任务 ---
+static void Task_Input(void)
+{
+    uint32_t msg;
+    while (Kernel_QueueGet(&key_queue, &msg, KERNEL_NO_WAIT)) {
+        KeyEXTI_HandleEvent(msg >> 8, msg & 0xFF);
+    }
+    LightControl_HandleInput();
+    Show_SaveResults();
+    Overlay_Update();
+    Trace_Poll();                       // 串口收到 'd' 时导出跟踪记录
+}
+
+static void Task_Display(void)
+{
+    Update_Display();
+}
+
+static void Task_Status(void)
+{
+    Update_SystemStatus();
+}
+
+static void Task_Chart(void)
+{
+    // 曲线页显示时只追加一列，其余时间只记录历史
+    Chart_AddSample(lp, spd, ds,
+                    display_page == DISPLAY_PAGE_CHART && LightControl_GetMode() != MODE_CONFIG &&
+                    !Overlay_IsActive());
+}
+
+// 负载统计：睡眠占比来自空闲线程（约 1s 窗口），循环频率来自控制周期计数，测距频率来自超声样本计数
+static void Task_Load(void)
+{
+    static uint32_t last_cycles = 0;
+    static uint32_t last_echo = 0;
+    static uint32_t last_time = 0;
+    Jitter_Stats_t js;
+    Ultrasonic_Sample_t echo;
+    uint32_t now = Time_Ms();
+
+    Jitter_GetStats(&js);
+    Ultrasonic_GetSample(&echo);
+    cpu_load = (uint8_t)((1000 - Sched_GetSleepPermille() + 5) / 10);   // 最近一个已结算窗口
+    if (last_time != 0 && now != last_time && js.cycles >= last_cycles) {
+        loop_hz = (js.cycles - last_cycles) * 1000UL / (now - last_time);
+        echo_hz = (echo.seq - last_echo) * 1000UL / (now - last_time);
+    }
+    last_cycles = js.cycles;
+    last_echo = echo.seq;
+    last_time = now;
+}
+
+// 任务表：名称、函数、周期、相位、优先级、截止时间（ms）
+// 相位错开各任务，避免同一毫秒内集中释放
+static Sched_Task_t tasks[] = {
+    SCHED_TASK("INPT", Task_Input,   INPUT_PERIOD_MS,   0,  0, 10),
+    SCHED_TASK("DISP", Task_Display, DISPLAY_UPDATE_MS, 10, 1, 100),
+    SCHED_TASK("STAT", Task_Status,  STATUS_PERIOD_MS,  15, 2, 50),
+    SCHED_TASK("CHRT", Task_Chart,   CHART_PERIOD_MS,   5,  3, 50),
+    SCHED_TASK("LOAD", Task_Load,    LOAD_PERIOD_MS,    7,  4, 500),
+};
+
+// --- 线程 ---
+// 灯光控制：固定速率，抢占界面和传感器读取；每周期相对计划释放时刻打点
+static void Thread_Control(void)
+{
+    uint32_t wake = Time_Ms();
+    while (1) {
+        Jitter_CycleStart(wake * 1000UL);   // SysTick 第 N 次节拍约在 N*1000us
+        TRACE_BEGIN(TRACE_CONTROL, 0);
+        Control_DrainEvents();
+        spd = Calculate_Real_Speed();
+        LightControl_Update(lp, spd, ds, &climate);
+        TRACE_END(TRACE_CONTROL, 0);
+        Jitter_CycleEnd();
+        Kernel_DelayUntil(&wake, CONTROL_PERIOD_MS);
+    }
+}
+
+// 界面：按键、提示、显示刷新由协作调度器分时执行，空闲时推送显存
+static void Thread_UI(void)
+{
+    Sched_Init(tasks, sizeof(tasks) / sizeof(tasks[0]), Time_Ms());
+    while (1) {
+        while (Sched_Run(Time_Ms()));
+        Display_Idle(Sched_NextRelease());
+    }
+}
+
+// 存储：等待保存请求，擦写 Flash 后把结果交给界面线程
+static void Thread_Persist(void)
+{
+    while (1) {
+        Kernel_SemWait(&save_sem, KERNEL_WAIT_FOREVER);
+        uint8_t source = save_source;
+        uint8_t ok = Config_SaveParams();
+        Kernel_QueuePut(&save_result_queue, ((uint32_t)source << 8) | ok);
+    }
+}
+
+// 传感器：读取耗时不定，优先级低于控制和界面
+static void Thread_Sensors(void)
 {
-    uint32_t last_sample = 0;
-    uint32_t last_display_update = 0;
+    uint32_t wake = Time_Ms();
+    while (1) {
+        Read_AllSensors();
+#if LOAD_TEST_BUSY_MS
+        Delay_ms(LOAD_TEST_BUSY_MS);
+#endif
+        Kernel_DelayUntil(&wake, SAMPLE_INTERVAL_MS);
+    }
+}
 
+// 空闲：无线程就绪时睡眠，并统计睡眠占比
+static void Thread_Idle(void)
+{
+    while (1) {
+        Sched_Sleep();
+    }
+}
+
+int main(void)
+{
     SystemInit();
     SystemCoreClockUpdate();
+    NVIC_PriorityGroupConfig(IRQ_PRIORITY_GROUP);   // 各中断优先级见 IrqPrio.h
+    IsrStat_Init();                                 // 开中断前填充主栈
     Delay_Init();
+    Trace_Init();                                   // 需在 DWT 计数启动后
 
     LED_Init();
     LED1_ON();
@@ -308,42 +568,44 @@ int main(void)
     OLED_Init();
     OLED_Clear();
     OLED_ShowString(2, 3, "System Ready");
+    OLED_Flush();
     Delay_ms(1500);
-    OLED_Clear();
-    Delay_ms(50);
-
-    display_buffer.valid = 0;
+    Overlay_Init(Redraw_OLED_Labels);
     Redraw_OLED_Labels();
 
     PWM_Init();
     Config_Init();
+    Event_Init();
+    EchoFilter_Init(&echo_filter);
     KeyEXTI_Init();
     CountSensor_Init();
     CountSensor_Reset();
     LDR_Init();
+    Chart_Init();
     DHT11_Init();
     Ultrasonic_Init();
     LightControl_Init();
 
-    last_pulse_count = CountSensor_Get();
-    last_calc_time = GetTick();
     spd = 0;
 
-    while (1) {
-        uint32_t now = GetTick();
-        spd = Calculate_Real_Speed();
-        if (now - last_sample >= SAMPLE_INTERVAL_MS) {
-            Read_AllSensors();
-            last_sample = now;
-        }
-        if (now - last_display_update >= DISPLAY_UPDATE_MS) {
-            Update_Display();
-            last_display_update = now;
-        }
-        LightControl_Update(lp, spd, ds, tp, hp);
-        Update_SystemStatus();
-        Delay_ms(IDLE_LOOP_MS);
-    }
+    Jitter_Init(CONTROL_DEADLINE_US);
+    Prof_Reset();
+    Kernel_Init();
+    Kernel_SemInit(&save_sem, 0, 1);
+    Kernel_QueueInit(&save_result_queue, save_result_buffer, SAVE_QUEUE_SIZE);
+    Kernel_QueueInit(&key_queue, key_buffer, KEY_QUEUE_SIZE);
+    Kernel_CreateThread(&thread_control, "CTRL", Thread_Control, PRIO_CONTROL,
+                        stack_control, sizeof(stack_control));
+    Kernel_CreateThread(&thread_ui, "UI", Thread_UI, PRIO_UI, stack_ui, sizeof(stack_ui));
+    Kernel_CreateThread(&thread_persist, "SAVE", Thread_Persist, PRIO_PERSIST,
+                        stack_persist, sizeof(stack_persist));
+    Kernel_CreateThread(&thread_sensors, "SENS", Thread_Sensors, PRIO_SENSORS,
+                        stack_sensors, sizeof(stack_sensors));
+    Kernel_CreateThread(&thread_idle, "IDLE", Thread_Idle, PRIO_IDLE,
+                        stack_idle, sizeof(stack_idle));
+    Time_SetTickHook(Kernel_Tick);
+
+    Kernel_Start();   // 不返回
 }
 
 // wrapper实现
@@ -351,7 +613,5 @@ uint32_t CountSensor_GetSpeed(uint16_t c, uint32_t dt_ms, uint32_t pd_cm) {
     if (dt_ms == 0) return 0;
     return (uint32_t)c * pd_cm * 1000UL / dt_ms;
 }
-uint8_t DHT11_Read(uint8_t *t, uint8_t *h) { return DHT11_Read_Data(t, h); }
 uint8_t LDR_GetPercent(void) { return LDR_Percent(); }
 void    LED1_Toggle(void) { LED1_Turn(); }
-float   Ultrasonic_GetDistance(void) { return UltrasonicGetLength(); }
@@ -118,24 +118,9 @@ void DebugMon_Handler(void)
 {
 }
 
-/**
-  * @brief  This function handles PendSVC exception.
-  * @param  None
-  * @retval None
-  */
-void PendSV_Handler(void)
-{
-}
+/* PendSV_Handler is implemented in System/Kernel.c (thread context switch) */
 
-/**
-  * @brief  This function handles SysTick Handler.
-  * @param  None
-  * @retval None
-  */
-void SysTick_Handler(void)
-{
-
-}
+/* SysTick_Handler is implemented in System/Timebase.c (1 ms timebase) */
 
 
 